@@ -0,0 +1,618 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "include/checkpoint.hpp"
+#include "include/ensemble.hpp"
+#include "include/gillespie.hpp"
+#include "include/recorder.hpp"
+#include "include/simulation.hpp"
+#include "include/sweep.hpp"
+#include "include/tau_leaping.hpp"
+#include "include/video.hpp"
+
+/**
+ * @brief Print the usage of the batch driver
+ *
+ * @param program The name of the program
+ */
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s <model> [options]\n"
+            "Run the simulation without display, as fast as possible.\n\n"
+            "Options:\n"
+            "  --engine <e>    Engine: particle, ssa for the well-mixed exact engine,\n"
+            "                  or tau for the well-mixed tau-leaping engine (default: particle)\n"
+            "  --epsilon <e>   Error parameter of the tau-leaping engine (default: 0.03)\n"
+            "  --implicit      Use the implicit tau-leaping, for the stiff models\n"
+            "  --seed <n>      Seed of the random generators (default: 1)\n"
+            "  --ticks <n>     Number of ticks to run (default: 1000)\n"
+            "  --time <t>      Run until the time of the simulation reaches t, instead of a number of ticks\n"
+            "                  (steps of the molecules, or reactions fired with ssa)\n"
+            "  --isa <i>       Kernel of the moves of the particle engine: scalar, avx2 or avx512\n"
+            "                  (default: the best one supported by the processor)\n"
+            "  --threads <n>   Use the parallel mode of the particle engine with n threads (default: 0, sequential mode)\n"
+            "                  With --replicates or --sweep, run the replicates on n threads (0: all the cores)\n"
+            "  --output <path> Write the final count of each species to a CSV file (default: stdout)\n"
+            "  --series <path> Stream the count of each species over time to a file\n"
+            "  --interval <n>  Number of ticks between two records of the series (default: 1)\n"
+            "  --format <f>    Format of the series: binary or csv (default: binary)\n"
+            "  --replicates <n> Run n replicates on the threads, and write the mean, the variance and the quantiles\n"
+            "                  of the count of each species every interval ticks, instead of the final count\n"
+            "  --sweep <path>  Run the model for each point of a sweep file (a grid or a Latin hypercube over\n"
+            "                  kcat, mM, diametre and vitesse), on the threads, and write one line per run\n"
+            "  --benchmark <n> Run n replicates with each engine, and compare their final counts and their speed\n"
+            "                  with those of the particle engine\n"
+            "  --compile <path> Compile the model to a binary file, which loads without parsing, and exit\n"
+            "  --checkpoint <path> Save the state of the particle engine to a file every checkpoint interval ticks\n"
+            "  --checkpoint-interval <n> Number of ticks between two checkpoints (default: 1000)\n"
+            "  --restore <path> Continue the run saved in a checkpoint, with the same model and options\n"
+            "  --video <path>  Render the particle engine every video interval ticks, without display, to PNG frames\n"
+            "                  (a pattern like frames/%%06d.png), a YUV stream (.y4m, - for stdout) or a pipe (|command)\n"
+            "  --video-interval <n> Number of ticks between two frames of the video (default: 10)\n"
+            "  --video-size <w>x<h> Size of the frames of the video (default: 1000x900)\n",
+            program);
+}
+
+/**
+ * @brief Create an engine from its name
+ *
+ * @param name The name of the engine: particle, ssa or tau
+ * @param threads The number of threads of the particle engine
+ * @param epsilon The error parameter of the tau-leaping engine
+ * @param implicit Use the implicit tau-leaping
+ * @return std::unique_ptr<Engine> The engine. (null if the name is unknown)
+ */
+static std::unique_ptr<Engine> make_engine(const char *name, unsigned int threads, double epsilon, bool implicit)
+{
+    if (!strcmp(name, "particle"))
+    {
+        auto simulation = std::make_unique<Simulation>();
+        simulation->set_threads(threads);
+        return simulation;
+    }
+
+    if (!strcmp(name, "ssa"))
+        return std::make_unique<Gillespie>();
+
+    if (!strcmp(name, "tau"))
+    {
+        auto tau_leaping = std::make_unique<TauLeaping>();
+        tau_leaping->m_epsilon = epsilon;
+        tau_leaping->m_implicit = implicit;
+        return tau_leaping;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Run replicates of the model with each engine, and print their mean final counts and their speed.
+ * The error of an engine is the mean relative difference of its mean counts with those of the particle engine
+ *
+ * @param model The parsed model
+ * @param replicates The number of replicates of each engine, with the seeds seed, seed + 1, ...
+ * @param seed The first seed
+ * @param ticks The number of ticks of each replicate
+ * @param threads The number of threads of the particle engine
+ * @param epsilon The error parameter of the tau-leaping engine
+ * @return int The exit code
+ */
+static int benchmark(std::shared_ptr<const Model> model, unsigned int replicates, uint64_t seed, unsigned long ticks, unsigned int threads, double epsilon)
+{
+    const char *names[] = {"particle", "ssa", "tau", "tau"};
+    const bool implicit[] = {false, false, false, true};
+
+    std::vector<double> reference;
+    std::vector<std::string> species;
+
+    for (int e = 0; e < 4; e++)
+    {
+        std::vector<double> means;
+        double elapsed = 0;
+
+        for (unsigned int r = 0; r < replicates; r++)
+        {
+            std::unique_ptr<Engine> engine = make_engine(names[e], threads, epsilon, implicit[e]);
+            engine->m_seed = seed + r;
+
+            try
+            {
+                engine->init(model);
+            }
+            catch (const std::exception &e)
+            {
+                fprintf(stderr, "Error: %s\n", e.what());
+                return 1;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            while (engine->m_tick < ticks)
+                engine->step();
+            elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            means.resize(engine->m_counts.size(), 0);
+            for (size_t s = 0; s < means.size(); s++)
+                means[s] += double(engine->m_counts[s]) / replicates;
+
+            if (species.empty())
+            {
+                for (size_t s = 0; s < engine->m_species.size(); s++)
+                    species.push_back(engine->species_name(s));
+
+                printf("engine,ticks/s,error");
+                for (auto &&name : species)
+                    printf(",\"%s\"", name.c_str());
+                printf("\n");
+            }
+        }
+
+        if (e == 0)
+            reference = means;
+
+        double error = 0;
+        for (size_t s = 0; s < means.size(); s++)
+            error += std::fabs(means[s] - reference[s]) / std::max(reference[s], 1.) / means.size();
+
+        printf("%s%s,%.1f,%.4f", names[e], implicit[e] ? "-implicit" : "", replicates * ticks / elapsed, error);
+        for (auto &&mean : means)
+            printf(",%.2f", mean);
+        printf("\n");
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argv[1][0] == '-')
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    char *model = argv[1];
+    const char *engine_name = "particle";
+    uint64_t seed = 1;
+    unsigned long ticks = 1000;
+    uint64_t time = 0;
+    unsigned int threads = 0;
+    double epsilon = 0.03;
+    bool implicit = false;
+    unsigned int replicates = 0;
+    unsigned int ensemble = 0;
+    const char *sweep = nullptr;
+    const char *compiled = nullptr;
+    const char *checkpoint_path = nullptr;
+    const char *restore = nullptr;
+    unsigned int checkpoint_interval = 1000;
+    const char *video_path = nullptr;
+    unsigned int video_interval = 10;
+    int video_width = 1000, video_height = 900;
+    const char *output = nullptr;
+    const char *series = nullptr;
+    unsigned int interval = 1;
+    Format format = BINARY;
+    int isa = -1;
+
+    // Parse the options
+    for (int i = 2; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+
+        if (!strcmp(argv[i], "--engine") && has_value)
+            engine_name = argv[++i];
+
+        else if (!strcmp(argv[i], "--epsilon") && has_value)
+            epsilon = strtod(argv[++i], nullptr);
+
+        else if (!strcmp(argv[i], "--implicit"))
+            implicit = true;
+
+        else if (!strcmp(argv[i], "--replicates") && has_value)
+            ensemble = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i], "--sweep") && has_value)
+            sweep = argv[++i];
+
+        else if (!strcmp(argv[i], "--checkpoint") && has_value)
+            checkpoint_path = argv[++i];
+
+        else if (!strcmp(argv[i], "--checkpoint-interval") && has_value)
+            checkpoint_interval = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i], "--restore") && has_value)
+            restore = argv[++i];
+
+        else if (!strcmp(argv[i], "--video") && has_value)
+            video_path = argv[++i];
+
+        else if (!strcmp(argv[i], "--video-interval") && has_value)
+            video_interval = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i], "--video-size") && has_value && sscanf(argv[i + 1], "%dx%d", &video_width, &video_height) == 2)
+            i++;
+
+        else if (!strcmp(argv[i], "--compile") && has_value)
+            compiled = argv[++i];
+
+        else if (!strcmp(argv[i], "--benchmark") && has_value)
+            replicates = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i], "--seed") && has_value)
+            seed = strtoull(argv[++i], nullptr, 10);
+
+        else if (!strcmp(argv[i], "--ticks") && has_value)
+            ticks = strtoul(argv[++i], nullptr, 10);
+
+        else if (!strcmp(argv[i], "--time") && has_value)
+            time = strtoull(argv[++i], nullptr, 10);
+
+        else if (!strcmp(argv[i], "--threads") && has_value)
+            threads = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i], "--isa") && has_value)
+        {
+            isa = -1;
+            i++;
+            for (Isa candidate : {SCALAR, AVX2, AVX512})
+                if (!strcmp(argv[i], isa_name(candidate)))
+                    isa = candidate;
+
+            if (isa == -1)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+
+        else if (!strcmp(argv[i], "--output") && has_value)
+            output = argv[++i];
+
+        else if (!strcmp(argv[i], "--series") && has_value)
+            series = argv[++i];
+
+        else if (!strcmp(argv[i], "--interval") && has_value)
+            interval = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i], "--format") && has_value)
+            format = !strcmp(argv[++i], "csv") ? CSV : BINARY;
+
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!make_engine(engine_name, 0, epsilon, implicit))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // The kernels are shared by all the particle engines of the run
+    if (isa != -1 && set_kernel_isa(Isa(isa)) != isa)
+        fprintf(stderr, "Warning: The processor does not support %s, the %s kernel is used\n", isa_name(Isa(isa)), isa_name(kernel_isa()));
+
+    if (video_path && !strcmp(video_path, "-") && !output)
+    {
+        fprintf(stderr, "Error: The video and the counts cannot both be written to the standard output, use --output\n");
+        return 1;
+    }
+
+    // Parse the model once, for all the engines
+    auto parsed = std::make_shared<Model>();
+
+    try
+    {
+        parsed->read_file(model);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+
+    if (compiled)
+    {
+        try
+        {
+            parsed->write_binary(compiled);
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (replicates)
+        return benchmark(parsed, replicates, seed, ticks, threads, epsilon);
+
+    if (sweep)
+    {
+        // The runs are in parallel, so each of them is sequential
+        Sweep runs(parsed, [&]
+                   { return make_engine(engine_name, 0, epsilon, implicit); },
+                   ticks);
+
+        try
+        {
+            runs.read_file(sweep, seed);
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+
+        ThreadPool pool(threads);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+            runs.run(seed, pool);
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        fprintf(stderr, "%zu runs of %lu ticks in %.3f s on %u threads\n", runs.m_points.size(), ticks, elapsed, pool.size());
+
+        FILE *fp = output ? fopen(output, "w") : stdout;
+
+        if (fp == NULL)
+        {
+            fprintf(stderr, "Error: The file %s could not be opened\n", output);
+            return 1;
+        }
+
+        runs.write(fp);
+
+        if (output)
+            fclose(fp);
+
+        return 0;
+    }
+
+    if (ensemble)
+    {
+        // The replicates run in parallel, so each of them is sequential
+        Ensemble runs(parsed, [&]
+                      { return make_engine(engine_name, 0, epsilon, implicit); },
+                      ticks, interval);
+
+        ThreadPool pool(threads);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+            runs.run(ensemble, seed, pool);
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        fprintf(stderr, "%u replicates of %lu ticks in %.3f s on %u threads\n", ensemble, ticks, elapsed, pool.size());
+
+        FILE *fp = output ? fopen(output, "w") : stdout;
+
+        if (fp == NULL)
+        {
+            fprintf(stderr, "Error: The file %s could not be opened\n", output);
+            return 1;
+        }
+
+        runs.write(fp);
+
+        if (output)
+            fclose(fp);
+
+        return 0;
+    }
+
+    // Create the engine
+    std::unique_ptr<Engine> engine = make_engine(engine_name, threads, epsilon, implicit);
+    engine->m_seed = seed;
+
+    // The checkpoints save the state of the particle engine
+    Simulation *simulation = dynamic_cast<Simulation *>(engine.get());
+    std::unique_ptr<Checkpoint> checkpoint;
+    std::unique_ptr<VideoWriter> video;
+
+    if ((checkpoint_path || restore) && !simulation)
+    {
+        fprintf(stderr, "Error: Only the particle engine can be saved to a checkpoint\n");
+        return 1;
+    }
+
+    if (video_path && !simulation)
+    {
+        fprintf(stderr, "Error: Only the particle engine has positions to render\n");
+        return 1;
+    }
+
+    try
+    {
+        engine->init(parsed);
+
+        if (restore)
+            Checkpoint::restore(restore, *simulation);
+
+        if (checkpoint_path)
+            checkpoint = std::make_unique<Checkpoint>(checkpoint_path);
+
+        if (video_path)
+        {
+            video = std::make_unique<VideoWriter>(video_path, video_width, video_height, simulation->m_species.size());
+            video->submit(*simulation);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+
+    // Open the time series
+    std::unique_ptr<Recorder> recorder;
+
+    if (series)
+    {
+        std::vector<std::string> names;
+        for (size_t s = 0; s < engine->m_species.size(); s++)
+            names.push_back(engine->species_name(s));
+
+        try
+        {
+            recorder = std::make_unique<Recorder>(series, format, names, interval);
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+
+        recorder->record(engine->m_tick, engine->m_time, engine->m_counts);
+    }
+
+    // Run the simulation. A restored run starts at the tick of its checkpoint
+    const unsigned int start_tick = engine->m_tick;
+    const auto start = std::chrono::steady_clock::now();
+
+    while (time ? engine->m_time < time : engine->m_tick < ticks)
+    {
+        // Stop when nothing can happen anymore, the time would never reach the end
+        if (time && engine->is_idle())
+            break;
+
+        engine->step();
+
+        if (recorder)
+        {
+            try
+            {
+                recorder->record(engine->m_tick, engine->m_time, engine->m_counts);
+            }
+            catch (const std::exception &e)
+            {
+                fprintf(stderr, "Error: %s\n", e.what());
+                return 1;
+            }
+        }
+
+        if (checkpoint && checkpoint_interval && engine->m_tick % checkpoint_interval == 0)
+        {
+            try
+            {
+                checkpoint->save(*simulation);
+            }
+            catch (const std::exception &e)
+            {
+                fprintf(stderr, "Error: %s\n", e.what());
+                return 1;
+            }
+        }
+
+        if (video && video_interval && engine->m_tick % video_interval == 0)
+        {
+            try
+            {
+                video->submit(*simulation);
+            }
+            catch (const std::exception &e)
+            {
+                fprintf(stderr, "Error: %s\n", e.what());
+                return 1;
+            }
+        }
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fprintf(stderr, "%u ticks in %.3f s (%.1f ticks/s), time %llu\n",
+            engine->m_tick - start_tick, elapsed, (engine->m_tick - start_tick) / elapsed, (unsigned long long)engine->m_time);
+
+    // Write the last rows of the time series
+    if (recorder)
+    {
+        try
+        {
+            recorder->close();
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+    }
+
+    // Wait for the last checkpoint
+    if (checkpoint)
+    {
+        try
+        {
+            checkpoint->close();
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+    }
+
+    // Wait for the last frames of the video
+    if (video)
+    {
+        try
+        {
+            video->close();
+        }
+        catch (const std::exception &e)
+        {
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+
+        fprintf(stderr, "%u frames written to %s\n", video->m_frames, video_path);
+    }
+
+    // Write the result
+    FILE *fp = output ? fopen(output, "w") : stdout;
+
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error: The file %s could not be opened\n", output);
+        return 1;
+    }
+
+    fprintf(fp, "species,count\n");
+    for (size_t s = 0; s < engine->m_counts.size(); s++)
+        fprintf(fp, "\"%s\",%u\n", engine->species_name(s).c_str(), engine->m_counts[s]);
+
+    if (output)
+        fclose(fp);
+
+    return 0;
+}
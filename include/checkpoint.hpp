@@ -0,0 +1,92 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulation.hpp"
+
+/**
+ * @brief The Checkpoint class saves the state of a simulation to a file, so a run can be continued after it stops.
+ *
+ * The state is copied to a buffer by the simulation, which goes on at once, and written by a background
+ * thread: the simulation fills one buffer while the other one is written. A state which has not started
+ * to be written is replaced by the next one. Each state is written to a temporary file, then renamed,
+ * so the file always holds a whole state, even if the program is killed while it writes.
+ *
+ * @param m_path The path of the file
+ */
+class Checkpoint
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The buffer filled by the simulation, and the state waiting for the writer
+    std::vector<char> m_buffer = std::vector<char>{};
+    std::vector<char> m_pending = std::vector<char>{};
+    bool m_ready = false;
+
+    // The error of the last write. (empty if it succeeded)
+    std::string m_error = "";
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::thread m_writer;
+    bool m_stop = false;
+
+    // PRIVATE METHODS
+    /**
+     * @brief The main function of the writer thread
+     */
+    void __write();
+    /**
+     * @brief Write a state to the temporary file, then rename it to the file
+     *
+     * @param state The state
+     * @return std::string The error. (empty if the state has been written)
+     */
+    std::string __write_state(const std::vector<char> &state);
+
+public:
+    std::string m_path = "";
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new Checkpoint object, and start its writer
+     *
+     * @param path The path of the file
+     */
+    Checkpoint(const std::string &path);
+    /**
+     * @brief Write the pending state and stop the writer, ignoring its error
+     */
+    ~Checkpoint();
+
+    Checkpoint(const Checkpoint &) = delete;
+    Checkpoint &operator=(const Checkpoint &) = delete;
+
+    // METHODS
+    /**
+     * @brief Copy the state of a simulation, and write it in the background
+     * Throw the error of the previous write, if it failed
+     *
+     * @param simulation The simulation
+     */
+    void save(const Simulation &simulation);
+    /**
+     * @brief Write the pending state and stop the writer
+     * Throw the error of a write, if one failed
+     */
+    void close();
+    /**
+     * @brief Continue a simulation from the state of a file
+     *
+     * @param path The path of the file
+     * @param simulation The simulation, initialized with the same model and overrides as the saved one
+     */
+    static void restore(const std::string &path, Simulation &simulation);
+};
+
+#endif // CHECKPOINT_HPP
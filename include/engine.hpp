@@ -0,0 +1,107 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <map>
+#include <cstdint>
+#include <memory>
+
+#include "model.hpp"
+#include "types.hpp"
+
+/**
+ * @brief The Engine class is the interface shared by the simulation engines.
+ *
+ * An engine is initialized from a model, then advances by ticks and counts the molecules of each species.
+ * The parsed model is shared between the engines through a shared_ptr: the names of the molecules and the
+ * table of the reactions between each pair of species are only kept by the model. The species table and
+ * the probabilities of the reactions are resolved once by the model, and each engine copies the diameters,
+ * the speeds and the counts of the species, and the reactions, to apply the overrides of its run.
+ * An enzyme bound to its substrate is counted as an enzyme, and its substrate is not counted anymore.
+ *
+ * @param m_overrides The parameters of the model changed for this engine
+ * @param m_species The species table. The species of the reactions are indices in this table
+ * @param m_counts The number of molecules of each species, updated at the end of each tick
+ * @param m_time The work done by the engine, in steps of a molecule or in reactions
+ * @param m_tick The number of ticks done
+ * @param m_seed The seed of the random generators
+ */
+class Engine
+{
+protected:
+    // PROTECTED ATTRIBUTES
+    std::shared_ptr<const Model> m_model = nullptr;
+    std::vector<react> m_reactions = std::vector<react>{};
+
+public:
+    // PUBLIC ATTRIBUTES
+    std::vector<Override> m_overrides = std::vector<Override>{};
+
+    // The species table. The species of the molecules and of the reactions are indices in this table
+    std::vector<Species> m_species = std::vector<Species>{};
+
+    // The number of molecules of each species, updated at the end of each tick
+    std::vector<unsigned int> m_counts = std::vector<unsigned int>{};
+
+    const float vesicle_diameter = 620;
+    // The work grows with the number of molecules, so it would wrap in 32 bits after a few thousand ticks
+    uint64_t m_time = 0;
+
+    // The number of ticks done, and the seed of the random generators
+    unsigned int m_tick = 0;
+    uint64_t m_seed = 1;
+
+    // DESTRUCTOR
+    virtual ~Engine() = default;
+
+    // PUBLIC METHODS
+    /**
+     * @brief Read a model file and initialize the engine with it
+     *
+     * @param data_path The path to the data file
+     */
+    void init(char *data_path);
+    /**
+     * @brief Initialize the engine
+     *
+     * @param model The parsed model
+     */
+    virtual void init(std::shared_ptr<const Model> model) = 0;
+    /**
+     * @brief Advance the engine by one tick
+     */
+    virtual void step() = 0;
+    /**
+     * @brief Check if the engine cannot change anymore, so the time would never advance
+     *
+     * @return true If no molecule can move and no reaction can fire
+     */
+    virtual bool is_idle() const = 0;
+    /**
+     * @brief Get the name of a species, from the names of the shared model
+     *
+     * @param s The index of the species in the species table
+     * @return const std::string& The name of the species
+     */
+    const std::string &species_name(size_t s) const;
+
+    /**
+     * @brief Keep the model, and copy its reactions with the overrides of the kinetic parameters
+     *
+     * @param model The parsed model
+     */
+    void init_model(std::shared_ptr<const Model> model);
+    /**
+     * Initialize the count of the molecules and the table of the species, with the overrides of the
+     * diameters and the speeds, and renumber the reactions with the indices of the species
+     */
+    void init_count_molecules();
+    /**
+     * Initialize the probabilities of the reactions
+     */
+    void init_probabilities();
+};
+
+#endif // ENGINE_HPP
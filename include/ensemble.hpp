@@ -0,0 +1,100 @@
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdio>
+#include <cstdint>
+
+#include "engine.hpp"
+#include "model.hpp"
+#include "random.hpp"
+#include "statistics.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief The Ensemble class runs many independent replicates of a model, and aggregates their counts.
+ *
+ * The model is parsed once and shared by all the replicates, which run on the threads of a pool,
+ * each with its own engine and its own seed. Every m_interval ticks, the count of each species of
+ * each replicate is added to online statistics (mean, variance and quantiles), so the trajectories
+ * of the replicates are never stored.
+ *
+ * @param m_model The parsed model
+ * @param m_ticks The number of ticks of each replicate
+ * @param m_interval The number of ticks between two records
+ */
+class Ensemble
+{
+private:
+    // PRIVATE ATTRIBUTES
+    std::shared_ptr<const Model> m_model = nullptr;
+
+    // Creates the engine of a replicate
+    std::function<std::unique_ptr<Engine>()> m_make_engine;
+
+    // The statistics of each species at each record, at [record * n_species + species]
+    std::vector<RunningStats> m_stats = std::vector<RunningStats>{};
+    std::vector<std::vector<P2Quantile>> m_quantiles = std::vector<std::vector<P2Quantile>>{};
+
+    std::mutex m_mutex;
+
+    // PRIVATE METHODS
+    /**
+     * @brief Add the counts of a replicate to the statistics of a record
+     *
+     * @param record The index of the record
+     * @param counts The count of each species
+     */
+    void __add(size_t record, const std::vector<unsigned int> &counts);
+
+public:
+    // PUBLIC ATTRIBUTES
+    unsigned long m_ticks = 0;
+    unsigned int m_interval = 1;
+
+    // The names of the species, known after the first replicate is initialized
+    std::vector<std::string> m_names = std::vector<std::string>{};
+
+    /* The quantiles estimated at each record */
+    static constexpr double m_QUANTILES[3] = {0.05, 0.5, 0.95};
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new Ensemble object
+     *
+     * @param model The parsed model
+     * @param make_engine The function which creates the engine of a replicate
+     * @param ticks The number of ticks of each replicate
+     * @param interval The number of ticks between two records
+     */
+    Ensemble(std::shared_ptr<const Model> model, std::function<std::unique_ptr<Engine>()> make_engine,
+             unsigned long ticks, unsigned int interval);
+
+    Ensemble(const Ensemble &) = delete;
+    Ensemble &operator=(const Ensemble &) = delete;
+
+    // METHODS
+    /**
+     * @brief Run the replicates on the threads of a pool
+     * The seed of the replicate 'r' is made from the seed and 'r', so the replicates do not depend on
+     * the number of threads. Only the quantiles, estimated online, depend a little on the order of the records.
+     * If a replicate fails to initialize, the replicates not started yet are skipped and the error is thrown
+     *
+     * @param replicates The number of replicates
+     * @param seed The seed of the ensemble
+     * @param pool The threads to use
+     */
+    void run(unsigned int replicates, uint64_t seed, ThreadPool &pool);
+    /**
+     * @brief Write the statistics as a CSV table "tick,species,mean,variance,q05,q50,q95"
+     *
+     * @param fp The file to write to
+     */
+    void write(FILE *fp) const;
+};
+
+#endif // ENSEMBLE_HPP
@@ -57,4 +57,24 @@ enum Ponct
     EQUAL
 };
 
+/**
+ * @brief The Parameter enum represents the parameters of a model which can be overridden.
+ */
+enum Parameter
+{
+    KCAT,
+    MM,
+    DIAMETER_OF,
+    SPEED_OF
+};
+
+/**
+ * @brief The Flag enum represents the state bits of a molecule during a tick.
+ */
+enum Flag
+{
+    SEEN = 1,
+    TO_DELETE = 2
+};
+
 #endif // ENUM_HPP
\ No newline at end of file
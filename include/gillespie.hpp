@@ -0,0 +1,140 @@
+#ifndef GILLESPIE_HPP
+#define GILLESPIE_HPP
+
+#include <vector>
+#include <limits>
+
+#include "engine.hpp"
+#include "random.hpp"
+
+/**
+ * @brief The Gillespie class is the well-mixed engine, an exact stochastic simulation (SSA).
+ *
+ * The molecules have no position: only the count of each species is kept, and the reactions
+ * are fired one by one with the next reaction method of Gibson and Bruck. Each reaction has
+ * 3 channels, with rates per tick taken from the probabilities of the particle engine:
+ *  - E + s -> Es, at p1 * (d / R)^3 for each pair of free molecules, where d is the mean
+ *    diameter of the two molecules and R the radius of the vesicle. In the particle engine, a
+ *    molecule only tests the molecules which have not moved yet in the tick, so each pair is
+ *    tested once per tick, when the first of the two moves,
+ *  - Es -> E + p, at p2 for each bound enzyme,
+ *  - Es -> E + s, at p3 - p2 for each bound enzyme.
+ * As in the particle engine, only the first reaction of a pair of species can bind them.
+ *
+ * The next time of each channel is kept in an indexed binary heap, so firing a reaction costs
+ * O(log n) plus the update of the channels which depend on it.
+ *
+ * @param m_clock The time of the engine, in ticks
+ * @param m_bound The number of bound enzymes of each reaction
+ */
+class Gillespie : public Engine
+{
+protected:
+    // PROTECTED ATTRIBUTES
+    Xoshiro256 m_random = Xoshiro256();
+
+    // The number of bound enzymes of each species, which are not free to bind
+    std::vector<unsigned int> m_bound_enzymes = std::vector<unsigned int>{};
+
+    // The rate constant of each channel, and its current rate (propensity)
+    std::vector<double> m_constants = std::vector<double>{};
+    std::vector<double> m_rates = std::vector<double>{};
+
+    // The channels to update after each channel fires, in a flat list
+    std::vector<int> m_dependents_start = std::vector<int>{};
+    std::vector<int> m_dependents = std::vector<int>{};
+
+    // The indexed heap: the next time of each channel, the channels sorted by time, and the position of each channel in the heap
+    std::vector<double> m_times = std::vector<double>{};
+    std::vector<int> m_heap = std::vector<int>{};
+    std::vector<int> m_heap_position = std::vector<int>{};
+
+    // PROTECTED METHODS
+    /**
+     * @brief Compute the current rate of a channel
+     *
+     * @param channel The index of the channel
+     * @return double The rate of the channel, per tick
+     */
+    double __rate(int channel) const;
+    /**
+     * @brief Change the counts of the species when a channel fires
+     *
+     * @param channel The index of the channel
+     * @param count The number of times the channel fires
+     */
+    void __fire(int channel, unsigned int count = 1);
+    /**
+     * @brief Draw the time to the next firing of a channel
+     *
+     * @param rate The rate of the channel
+     * @return double The time to the next firing. (infinite if the rate is 0)
+     */
+    double __draw_delay(double rate);
+    /**
+     * @brief Move a channel up the heap, until its parent is sooner
+     *
+     * @param position The position of the channel in the heap
+     */
+    void __sift_up(int position);
+    /**
+     * @brief Move a channel down the heap, until its children are later
+     *
+     * @param position The position of the channel in the heap
+     */
+    void __sift_down(int position);
+    /**
+     * @brief Set the next time of a channel and restore the order of the heap
+     *
+     * @param channel The index of the channel
+     * @param time The next time of the channel
+     */
+    void __update(int channel, double time);
+    /**
+     * @brief Fire the reactions one by one, until a time or a number of reactions
+     * The clock is left at the time of the last reaction
+     *
+     * @param end The time to stop at
+     * @param reactions The maximum number of reactions to fire
+     * @return unsigned int The number of reactions fired
+     */
+    unsigned int __run(double end, unsigned int reactions);
+
+public:
+    // PUBLIC ATTRIBUTES
+    double m_clock = 0;
+
+    std::vector<unsigned int> m_bound = std::vector<unsigned int>{};
+
+    /* The number of channels of each reaction */
+    static const int m_CHANNELS = 3;
+
+    // PUBLIC METHODS
+    using Engine::init;
+    /**
+     * @brief Initialize the engine
+     *
+     * @param model The parsed model
+     */
+    void init(std::shared_ptr<const Model> model) override;
+    /**
+     * Initialize the rate constants of the channels, and the channels which depend on each channel
+     */
+    void init_channels();
+    /**
+     * Draw the first time of each channel, and build the heap
+     */
+    void init_heap();
+    /**
+     * @brief Fire the reactions until the next tick
+     */
+    void step() override;
+    /**
+     * @brief Check if the rate of every channel is 0
+     *
+     * @return true If no reaction can fire anymore
+     */
+    bool is_idle() const override;
+};
+
+#endif // GILLESPIE_HPP
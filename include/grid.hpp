@@ -0,0 +1,73 @@
+#ifndef GRID_HPP
+#define GRID_HPP
+
+#include <vector>
+
+#include "molecules.hpp"
+
+/**
+ * @brief The Grid class is a uniform cell list over the vesicle.
+ *
+ * The vesicle is cut into cubic cells at least as wide as the largest collision distance,
+ * so two molecules can only collide if they are in the same or in adjacent cells.
+ * The molecules are bucketed by a counting sort: the indices of the molecules of the cell 'c'
+ * are m_indices[m_cell_start[c]] ... m_indices[m_cell_start[c + 1] - 1], in increasing order.
+ * The position and the radius of the molecules are copied in the same order, so a query reads
+ * contiguous memory. The copies are only valid for the molecules which have not moved since the build.
+ *
+ * @param m_cells The number of cells along each axis
+ * @param m_cell_size The width of a cell
+ * @param m_origin The lowest coordinate covered by the grid on each axis
+ */
+class Grid
+{
+public:
+    /* The maximum number of cells along each axis */
+    static const int m_MAX_CELLS = 128;
+
+    int m_cells = 1;
+    float m_cell_size = 1;
+    float m_origin = 0;
+
+    std::vector<int> m_cell_start = std::vector<int>{};
+    std::vector<int> m_indices = std::vector<int>{};
+
+    // The position and the radius of the molecules, in the order of m_indices
+    std::vector<float> m_x = std::vector<float>{};
+    std::vector<float> m_y = std::vector<float>{};
+    std::vector<float> m_z = std::vector<float>{};
+    std::vector<float> m_radius = std::vector<float>{};
+
+    // Methods
+    /**
+     * @brief Initialize the grid
+     *
+     * @param extent The width of the cube covered by the grid, centered on the origin
+     * @param min_cell_size The minimal width of a cell (the largest collision distance)
+     */
+    void init(float extent, float min_cell_size);
+    /**
+     * @brief Bucket the molecules in the cells of the grid
+     *
+     * @param molecules The molecules of the simulation
+     */
+    void build(const MoleculeStore &molecules);
+    /**
+     * @brief Get the cell coordinate along one axis, clamped to the grid
+     *
+     * @param v The coordinate
+     * @return int The cell coordinate
+     */
+    int axis(float v) const;
+    /**
+     * @brief Get the index of the cell at the given cell coordinates
+     *
+     * @param cx The cell coordinate along the x axis
+     * @param cy The cell coordinate along the y axis
+     * @param cz The cell coordinate along the z axis
+     * @return int The index of the cell
+     */
+    int cell(int cx, int cy, int cz) const;
+};
+
+#endif // GRID_HPP
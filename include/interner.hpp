@@ -0,0 +1,103 @@
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The Interner class is the symbol table of the lexer.
+ *
+ * Each distinct string gets a dense id, in the order of its first insertion, so the ids of n strings
+ * are 0..n-1. The ids are found with an open-addressing hash table, which doubles when it is half
+ * full. The strings which must be copied are stored in an arena of large blocks, which never moves
+ * them, so the views of the table stay valid as long as the interner.
+ *
+ * @param m_symbols The string of each id
+ */
+class Interner
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The hash table: the id of the string in each slot, -1 for an empty slot. (its size is a power of 2)
+    std::vector<int> m_slots = std::vector<int>(m_INITIAL_SLOTS, -1);
+
+    // The hash of each id, kept to rebuild the table when it grows
+    std::vector<uint32_t> m_hashes = std::vector<uint32_t>{};
+
+    // The blocks of the arena, and the number of bytes used in the last one. (full when there is no block)
+    std::vector<std::unique_ptr<char[]>> m_arena = std::vector<std::unique_ptr<char[]>>{};
+    size_t m_arena_used = m_ARENA_BLOCK;
+
+    // PRIVATE METHODS
+    /**
+     * @brief Hash a string, with FNV-1a
+     *
+     * @param s The string to hash
+     * @return uint32_t The hash of the string
+     */
+    static uint32_t __hash(std::string_view s);
+    /**
+     * @brief Find the slot of a string, or the empty slot where it would be inserted
+     *
+     * @param s The string
+     * @param h The hash of the string
+     * @return size_t The slot
+     */
+    size_t __slot(std::string_view s, uint32_t h) const;
+    /**
+     * @brief Double the hash table, and insert the ids again
+     */
+    void __grow();
+    /**
+     * @brief Copy a string in the arena
+     *
+     * @param s The string to copy
+     * @return std::string_view The copy
+     */
+    std::string_view __copy(std::string_view s);
+
+public:
+    // PUBLIC ATTRIBUTES
+    std::vector<std::string_view> m_symbols = std::vector<std::string_view>{};
+
+    /* The number of slots of an empty table */
+    static const size_t m_INITIAL_SLOTS = 64;
+
+    /* The size of a block of the arena. (a longer string has its own block) */
+    static const size_t m_ARENA_BLOCK = 1 << 16;
+
+    // PUBLIC METHODS
+    /**
+     * @brief Find the id of a string
+     *
+     * @param s The string
+     * @return int The id of the string. -1 if the string is not in the table
+     */
+    int find(std::string_view s) const;
+    /**
+     * @brief Get the id of a string, and insert it if it is not in the table
+     *
+     * @param s The string
+     * @param copy If the string must be copied in the arena. Otherwise it must outlive the interner
+     * @return int The id of the string
+     */
+    int intern(std::string_view s, bool copy = true);
+    /**
+     * @brief Get the number of strings
+     *
+     * @return size_t The number of strings, and the next id
+     */
+    size_t size() const { return m_symbols.size(); }
+    /**
+     * @brief Get the string of an id
+     *
+     * @param id The id
+     * @return std::string_view The string
+     */
+    std::string_view operator[](int id) const { return m_symbols[id]; }
+};
+
+#endif // INTERNER_HPP
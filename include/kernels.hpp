@@ -0,0 +1,88 @@
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "molecules.hpp"
+#include "random.hpp"
+
+/**
+ * @brief The Isa enum represents the instruction sets the kernels are written for.
+ */
+enum Isa
+{
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief The Moves struct holds the moves proposed for the molecules during a tick.
+ *
+ * @param m_x The x position proposed for the molecules
+ * @param m_y The y position proposed for the molecules
+ * @param m_z The z position proposed for the molecules
+ * @param m_proba The random number used to check if a reaction occurs
+ * @param m_inside 1 if the proposed position is inside the vesicle, 0 otherwise
+ */
+struct Moves
+{
+    std::vector<float> m_x = std::vector<float>{};
+    std::vector<float> m_y = std::vector<float>{};
+    std::vector<float> m_z = std::vector<float>{};
+    std::vector<float> m_proba = std::vector<float>{};
+    std::vector<unsigned char> m_inside = std::vector<unsigned char>{};
+
+    /**
+     * @brief Resize the arrays of the moves
+     *
+     * @param n The number of molecules
+     */
+    void resize(size_t n);
+};
+
+/**
+ * @brief Propose a random move for a batch of molecules
+ *
+ * The molecule 'i' draws the Philox numbers of the counter 'i' in the stream 'tick'.
+ * It moves by its speed in a uniform direction of the xy plane, and up or down along z.
+ * The moves that leave the vesicle are masked out with a squared distance, without sqrt.
+ * The SIMD and the scalar kernels do the same operations, so they give the same moves.
+ *
+ * @param molecules The molecules of the simulation
+ * @param philox The counter-based random generator
+ * @param tick The current tick
+ * @param radius The radius of the vesicle
+ * @param first The index of the first molecule of the batch
+ * @param count The number of molecules of the batch
+ * @param moves The moves to fill, sized for all the molecules
+ */
+void propose_moves(const MoleculeStore &molecules, const Philox &philox, uint64_t tick, float radius,
+                   size_t first, size_t count, Moves &moves);
+
+/**
+ * @brief Get the instruction set used by the kernels
+ * The best one supported by the processor is chosen at the first call
+ *
+ * @return Isa The instruction set
+ */
+Isa kernel_isa();
+/**
+ * @brief Force the instruction set used by the kernels
+ * If the processor does not support it, the best supported one is kept
+ *
+ * @param isa The instruction set
+ * @return Isa The instruction set now used
+ */
+Isa set_kernel_isa(Isa isa);
+/**
+ * @brief Get the name of an instruction set
+ *
+ * @param isa The instruction set
+ * @return const char* The name
+ */
+const char *isa_name(Isa isa);
+
+#endif // KERNELS_HPP
@@ -4,8 +4,11 @@
 #include <stdio.h>
 #include <cstdlib>
 #include <string.h>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "interner.hpp"
 #include "types.hpp"
 
 /**
@@ -14,38 +17,53 @@
  * This class is responsible for the lexical analysis of the input file.
  * The lexical analysis is the process of converting a sequence of characters into a sequence of tokens.
  * The tokens are the smallest units of the language.
+ *
+ * A file can be read with a FILE*, one character at a time, or mapped in memory with lex_mapped(),
+ * which scans it in a single pass with pointer arithmetic. In the mapped mode, the identifiers of the
+ * table point into the mapping, which stays open as long as the lexer. The identifiers read from a
+ * FILE* are copied.
+ *
+ * The identifiers get dense ids, in the order they first appear in the file.
  * 
- * @param m_table The hash table
+ * @param m_table The symbol table
  */
 class Lexer
 {
-public:
-    /* The size of the hash table */
-    static const int m_HASH_SIZE = 200000;
+private:
+    // PRIVATE ATTRIBUTES
+    // The mapped files, as <address, size>, unmapped by the destructor
+    std::vector<std::pair<void *, size_t>> m_mappings = std::vector<std::pair<void *, size_t>>{};
+
+    // PRIVATE METHODS
+    /**
+     * @brief Read the next token of a mapped file
+     *
+     * @param cursor The position in the file, moved after the token
+     * @param end The end of the file
+     * @return UL The next token
+     */
+    UL __lex_mapped(const char *&cursor, const char *end);
 
-    /* The hash table */
-    char *m_table[m_HASH_SIZE] = {0};
+public:
+    /* The symbol table, the name of each id */
+    Interner m_table = Interner();
 
     // Constructor and destructor
     Lexer();
     ~Lexer();
 
+    Lexer(const Lexer &) = delete;
+    Lexer &operator=(const Lexer &) = delete;
+
     // Methods
-    /**
-     * @brief The hash function
-     *
-     * @param s The string to hash
-     * @return int The hash of the string
-     */
-    int hash(char *s);
     /**
      * @brief The index function
      *
      * @param s The string to index
      * @param insert If the string should be inserted in the table
-     * @return int The index of the string. -1 if the string is not in the table. -2 if the table is full
+     * @return int The index of the string. -1 if the string is not in the table
      */
-    int index(char *s, bool insert);
+    int index(std::string_view s, bool insert);
     /**
      * @brief The lex function
      *
@@ -60,6 +78,14 @@ public:
      * @return std::vector<UL> The vector of tokens
      */
     std::vector<UL> lex_all(FILE *fp);
+    /**
+     * @brief Map a file in memory and lex it in a single pass
+     * The identifiers are not copied, and point into the mapping
+     *
+     * @param path The path to the file
+     * @return std::vector<UL> The vector of tokens
+     */
+    std::vector<UL> lex_mapped(const char *path);
     /**
      * @brief The print_ul function
      *
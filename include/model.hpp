@@ -0,0 +1,97 @@
+#ifndef MODEL_HPP
+#define MODEL_HPP
+
+#include <vector>
+#include <string>
+#include <map>
+#include <tuple>
+#include <cstdint>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "types.hpp"
+
+/**
+ * @brief The Model struct is a parsed model file, shared by all the engines which run it.
+ *
+ * A model is read once, then any number of engines can be initialized from it,
+ * each with its own copy of the reactions and the instructions.
+ *
+ * A model can also be compiled to a binary file with write_binary(): the names, the reactions with
+ * their probabilities, the instructions and the species table, resolved once. read_file() recognizes
+ * a compiled model by its magic number and maps it in memory, without lexing nor parsing it.
+ *
+ * @param m_instructions The instructions of the model
+ * @param m_reactions The reactions of the model, with the ids of the lexer table and their probabilities
+ * @param m_names The names of the molecules, by id
+ * @param m_species The species table of the model, sorted by id, without the overrides of the engines
+ * @param m_reaction_table The first reaction between each pair of species of the table, shared by the engines
+ */
+struct Model
+{
+    std::vector<instr> m_instructions = std::vector<instr>{};
+    std::vector<react> m_reactions = std::vector<react>{};
+    std::vector<std::string> m_names = std::vector<std::string>{};
+    std::vector<Species> m_species = std::vector<Species>{};
+
+    // The reaction between the species 'a' and 'b' is m_reaction_table[a * n_species + b]. (-1 if not present)
+    // The species are the indices in m_species, the overrides of the engines never change it
+    std::vector<int> m_reaction_table = std::vector<int>{};
+
+    /* The magic number at the start of a compiled model */
+    static constexpr char m_MAGIC[8] = {'E', 'N', 'Z', 'Y', 'M', 'O', 'D', 0};
+
+    /* The version of the format of the compiled models, changed with their layout */
+    static const uint32_t m_VERSION = 1;
+
+    // METHODS
+    /**
+     * @brief Read the file and parse it, to get the instructions and reactions of the model
+     * A compiled model is loaded instead of parsed
+     *
+     * @param data_path The path to the data file
+     */
+    void read_file(const char *data_path);
+    /**
+     * @brief Compile the model to a binary file, which can be loaded without parsing
+     *
+     * @param path The path to the binary file
+     */
+    void write_binary(const char *path) const;
+    /**
+     * @brief Compute the probabilities of the reactions, and build the species table and the table of the reactions
+     */
+    void resolve();
+    /**
+     * @brief Compute the probabilities of a reaction 'e: s -> p' from its kcat and mM
+     * [p1]: E + s -> Es
+     * [p2]: Es -> E + s
+     * [p3]: Es -> E + p
+     *
+     * @param reaction The reaction
+     */
+    static void compute_probabilities(react &reaction);
+
+private:
+    // PRIVATE METHODS
+    /**
+     * @brief Get the instructions of each molecule
+     * map<ident, <count, diameter, speed>>
+     *
+     * @return std::map<int, std::tuple<int, int, int>> The instructions of each molecule
+     */
+    std::map<int, std::tuple<int, int, int>> __map_instructions() const;
+    /**
+     * @brief Map each pair of species to the first reaction between them, in both orders
+     */
+    void __build_reaction_table();
+    /**
+     * @brief Load a compiled model
+     *
+     * @param data The mapped file
+     * @param size The size of the file
+     */
+    void __read_binary(const char *data, size_t size);
+};
+
+#endif // MODEL_HPP
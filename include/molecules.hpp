@@ -0,0 +1,120 @@
+#ifndef MOLECULES_HPP
+#define MOLECULES_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "enums.hpp"
+#include "types.hpp"
+
+/**
+ * @brief The MoleculeStore class stores the molecules of the simulation as a structure of arrays.
+ *
+ * Each attribute of the molecules is a contiguous array, so the loops over the positions
+ * do not load the rest of the molecule. The molecule 'i' is made of the i-th element of every array.
+ * The cold data of a molecule (its name, ...) is found in the species table with m_species[i].
+ *
+ * The indices stay valid during a whole tick: a molecule is removed by marking it as a tombstone
+ * with remove(), the new molecules are kept aside by the caller, and compact() then removes all the
+ * tombstones in one stable pass at the end of the tick, before the new molecules are added.
+ *
+ * @param m_x The x position of the molecules
+ * @param m_y The y position of the molecules
+ * @param m_z The z position of the molecules
+ * @param m_diameter The diameter of the molecules
+ * @param m_speed The speed of the molecules
+ * @param m_species The index of the species of the molecules in the species table
+ * @param m_reaction The index of the reaction bound to the molecules. (-1 if not present)
+ * @param m_flags The state bits of the molecules, see the Flag enum
+ */
+class MoleculeStore
+{
+public:
+    // ATTRIBUTES
+    std::vector<float> m_x = std::vector<float>{};
+    std::vector<float> m_y = std::vector<float>{};
+    std::vector<float> m_z = std::vector<float>{};
+    std::vector<float> m_diameter = std::vector<float>{};
+    std::vector<float> m_speed = std::vector<float>{};
+    std::vector<int> m_species = std::vector<int>{};
+    std::vector<int> m_reaction = std::vector<int>{};
+    std::vector<unsigned char> m_flags = std::vector<unsigned char>{};
+
+    // METHODS
+    /**
+     * @brief Get the number of molecules
+     *
+     * @return size_t The number of molecules
+     */
+    size_t size() const;
+    /**
+     * @brief Reserve the memory for a number of molecules
+     *
+     * @param n The number of molecules
+     */
+    void reserve(size_t n);
+    /**
+     * @brief Add a molecule at the end of the store
+     *
+     * @param species The index of the species of the molecule
+     * @param diameter The diameter of the molecule
+     * @param speed The speed of the molecule
+     * @param position The position of the molecule
+     * @return int The index of the new molecule
+     */
+    int push_back(int species, float diameter, float speed, const Coord &position);
+    /**
+     * @brief Mark a molecule as a tombstone, removed at the next compaction
+     * The molecule is also marked as seen, so it takes no more part in the tick
+     *
+     * @param i The index of the molecule
+     */
+    void remove(size_t i);
+    /**
+     * @brief Remove the tombstones, keeping the order of the other molecules, and clear their seen flag
+     *
+     * @param counts The count of each species, decremented for each molecule removed. (ignored if null)
+     * @return size_t The number of molecules removed
+     */
+    size_t compact(std::vector<unsigned int> *counts = nullptr);
+
+    /**
+     * @brief Get the position of a molecule
+     *
+     * @param i The index of the molecule
+     * @return Coord The position of the molecule
+     */
+    Coord position(size_t i) const;
+    /**
+     * @brief Set the position of a molecule
+     *
+     * @param i The index of the molecule
+     * @param position The new position of the molecule
+     */
+    void set_position(size_t i, const Coord &position);
+
+    /**
+     * @brief Check if a flag of a molecule is set
+     *
+     * @param i The index of the molecule
+     * @param flag The flag to check
+     * @return bool True if the flag is set and false otherwise
+     */
+    bool is(size_t i, Flag flag) const;
+    /**
+     * @brief Set a flag of a molecule
+     *
+     * @param i The index of the molecule
+     * @param flag The flag to set
+     */
+    void set(size_t i, Flag flag);
+    /**
+     * @brief Clear a flag of a molecule
+     *
+     * @param i The index of the molecule
+     * @param flag The flag to clear
+     */
+    void unset(size_t i, Flag flag);
+};
+
+#endif // MOLECULES_HPP
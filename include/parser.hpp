@@ -7,20 +7,67 @@
 #include "enums.hpp"
 #include "types.hpp"
 
+/**
+ * @brief The TokenCursor struct reads the tokens of the lexer one after the other.
+ *
+ * The tokens are never copied nor erased: the cursor only moves its position,
+ * so parsing a model is linear in the number of tokens.
+ *
+ * @param m_tokens The tokens of the lexer
+ * @param m_position The position of the current token
+ */
+struct TokenCursor
+{
+    const std::vector<UL> *m_tokens = nullptr;
+    size_t m_position = 0;
+
+    // Constructors
+    /**
+     * @brief Construct a new TokenCursor object on the first token
+     *
+     * @param tokens The tokens of the lexer, which must outlive the cursor
+     */
+    TokenCursor(const std::vector<UL> &tokens) : m_tokens(&tokens) {}
+
+    // Methods
+    /**
+     * @brief Get the number of tokens left
+     *
+     * @return size_t The number of tokens left
+     */
+    size_t size() const { return m_tokens->size() - m_position; }
+    /**
+     * @brief Get a token after the current one
+     * Throw std::out_of_range if there are not enough tokens left
+     *
+     * @param i The offset of the token from the current one
+     * @return const UL& The token
+     */
+    const UL &at(size_t i) const { return m_tokens->at(m_position + i); }
+    /**
+     * @brief Move to the next token
+     */
+    void advance() { m_position++; }
+};
+
 /**
  * @brief The Parser class is used to parse the tokenized data.
  */
 class Parser
 {
 public:
+    /* The factors applied to the values of the 'diametre' and 'vitesse' instructions */
+    static constexpr float m_DIAMETER_SCALE = 10;
+    static constexpr float m_SPEED_SCALE = 5;
+
     /**
      * @brief Parse the tokenized data
      *
-     * @param data_tokenized The tokenized data
+     * @param tokens The tokenized data
      * @param reactions The vector of reactions to fill
      * @param instructions The vector of instructions to fill
      */
-    void parse(std::vector<UL> data_tokenized, std::vector<react> &reactions, std::vector<instr> &instructions);
+    void parse(const std::vector<UL> &tokens, std::vector<react> &reactions, std::vector<instr> &instructions);
 
     /**
      * @brief Parse a reaction from the tokenized vector
@@ -29,7 +76,7 @@ public:
      * @param data_tokenized The tokenized data
      * @return react The reaction
      */
-    react reaction(std::vector<UL> &data_tokenized);
+    react reaction(TokenCursor &data_tokenized);
     /**
      * @brief Parse an instruction from the tokenized vector
      * For example: init(e) = 30;
@@ -37,7 +84,7 @@ public:
      * @param data_tokenized The tokenized data
      * @return instr The instruction
      */
-    instr instruction(std::vector<UL> &data_tokenized);
+    instr instruction(TokenCursor &data_tokenized);
 
     /**
      * @brief Parse a series of reactions from the tokenized vector
@@ -48,7 +95,7 @@ public:
      * @param data_tokenized The tokenized data
      * @return std::vector<react> The reactions
      */
-    std::vector<react> reactions_series(std::vector<UL> data_tokenized);
+    std::vector<react> reactions_series(TokenCursor data_tokenized);
     /**
      * @brief Parse a series of instructions from the tokenized vector
      * For example:
@@ -58,7 +105,7 @@ public:
      * @param data_tokenized The tokenized data
      * @return std::vector<instr> The instructions
      */
-    std::vector<instr> instructions_series(std::vector<UL> data_tokenized);
+    std::vector<instr> instructions_series(TokenCursor data_tokenized);
 
     /**
      * @brief Parse a series of identifications from the tokenized vector
@@ -67,7 +114,7 @@ public:
      * @param data_tokenized The tokenized data
      * @return std::tuple<float, float> The identifications
      */
-    std::tuple<float, float> idents_series(std::vector<UL> &data_tokenized);
+    std::tuple<float, float> idents_series(TokenCursor &data_tokenized);
 
     /**
      * @brief Parse a series of mM from the tokenized vector
@@ -76,7 +123,7 @@ public:
      * @param data_tokenized The tokenized data
      * @return std::tuple<float, float> The mM
      */
-    std::tuple<float, float> mM_series(std::vector<UL> &data_tokenized);
+    std::tuple<float, float> mM_series(TokenCursor &data_tokenized);
 
     /**
      * @brief Get the value of the current token and move to the next one
@@ -87,7 +134,7 @@ public:
      * @param exception The exception message if the token is not found
      * @return float The value of the current token
      */
-    float next_token(std::vector<UL> &data_tokenized, State type, std::string exception);
+    float next_token(TokenCursor &data_tokenized, State type, std::string exception);
     /**
      * @brief Check if the next token is the correct ponctuation and move to the next one
      *
@@ -95,7 +142,7 @@ public:
      * @param Ponct The ponctuation to find
      * @return bool True if the ponctuation is found and false otherwise
      */
-    bool next_symbol(std::vector<UL> &data_tokenized, Ponct symbol);
+    bool next_symbol(TokenCursor &data_tokenized, Ponct symbol);
     /**
      * @brief Check if the next token is the correct keyword and move to the next one
      *
@@ -103,7 +150,7 @@ public:
      * @param Keyword The keyword to find
      * @return bool True if the keyword is found and false otherwise
      */
-    bool next_keyword(std::vector<UL> &data_tokenized, Keyword keyword);
+    bool next_keyword(TokenCursor &data_tokenized, Keyword keyword);
     /**
      * @brief Check if the next token is the correct ponctuation and move to the next one
      * If the next token is not the correct ponctuation, throw an exception
@@ -112,7 +159,7 @@ public:
      * @param Ponct The ponctuation to find
      * @param exception The exception message if the ponctuation is not found
      */
-    void next_symbol_except(std::vector<UL> &data_tokenized, Ponct symbol, std::string exception);
+    void next_symbol_except(TokenCursor &data_tokenized, Ponct symbol, std::string exception);
 
     /**
      * @brief Print an instruction
@@ -0,0 +1,182 @@
+#ifndef PLACEMENT_HPP
+#define PLACEMENT_HPP
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+/**
+ * @brief The Placement class gives the start positions of the molecules, in a random order.
+ *
+ * The positions are the points of a cubic lattice inside the vesicle, a spacing apart. Instead of
+ * building and shuffling all the points, the indices of the lattice are visited in the order of a
+ * random permutation, made of a Feistel network keyed by the seed: each index comes once, and the
+ * points outside the vesicle are skipped. Only the positions used are computed, and the memory
+ * does not depend on the size of the lattice.
+ *
+ * @param m_radius The radius of the sphere the positions are in
+ * @param m_spacing The distance between two adjacent points of the lattice
+ * @param m_side The number of points along each axis of the lattice
+ */
+class Placement
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The keys of the rounds of the permutation
+    uint64_t m_keys[4] = {0, 0, 0, 0};
+
+    // The number of bits of each half of the permuted indices
+    unsigned int m_half_bits = 1;
+
+    // The number of indices visited
+    uint64_t m_visited = 0;
+
+    // PRIVATE METHODS
+    /**
+     * @brief Permute an index of the domain of the Feistel network, of 2 * m_half_bits bits
+     *
+     * @param index The index
+     * @return uint64_t The permuted index
+     */
+    uint64_t __permute(uint64_t index) const;
+
+public:
+    // PUBLIC ATTRIBUTES
+    float m_radius = 0;
+    float m_spacing = 1;
+    float m_side = 0;
+
+    // The number of points of the lattice, inside and outside the vesicle
+    uint64_t m_points = 0;
+
+    // CONSTRUCTORS
+    Placement() = default;
+    /**
+     * @brief Construct a new Placement object
+     * The lattice is the cube of side 'side', centered on the vesicle, as many spheres of
+     * diameter 'spacing' as fit in the volume of the sphere of radius 'radius'
+     *
+     * @param radius The radius of the sphere the positions are in
+     * @param spacing The distance between two adjacent positions
+     * @param seed The seed of the order of the positions
+     */
+    Placement(float radius, float spacing, uint64_t seed);
+
+    // METHODS
+    /**
+     * @brief Get the next position. Throw if all the positions of the vesicle are taken
+     *
+     * @return Coord The position
+     */
+    Coord next();
+};
+
+/**
+ * @brief The Packing class places molecules of different diameters in the vesicle, without overlaps.
+ *
+ * The molecules of each diameter take the points of their own lattice, a diameter apart, so a small
+ * molecule is not spaced as much as the largest one. The points of a lattice never overlap each other,
+ * so a point is only tested against the molecules of the other diameters, with a cell list of each
+ * diameter whose cells are as wide as the diameter. The cells are an array over the vesicle, or a hash
+ * table of the cells used when the array would be too large. The largest molecules should be placed first:
+ * the small ones then fill the space left between them, and their cell list, which no other diameter
+ * reads, is never built.
+ *
+ * @param m_vesicle_radius The radius of the vesicle
+ * @param m_offset The distance kept between the molecules and the membrane
+ */
+class Packing
+{
+private:
+    // PRIVATE TYPES
+    // The molecules of a diameter: their lattice, their positions, and the cell list of their positions,
+    // as the first molecule of each cell (in an array of side^3 cells, or in a hash table if side is 0),
+    // then the next molecule of the same cell. Only the first 'indexed' molecules are in the cell list
+    struct Group
+    {
+        Placement lattice = Placement();
+        std::vector<Coord> positions = std::vector<Coord>{};
+        size_t indexed = 0;
+        int64_t side = 0;
+        std::vector<int> cells = std::vector<int>{};
+        std::unordered_map<uint64_t, int> heads = std::unordered_map<uint64_t, int>{};
+        std::vector<int> next = std::vector<int>{};
+    };
+
+    // PRIVATE ATTRIBUTES
+    std::map<float, Group> m_groups = std::map<float, Group>{};
+
+    uint64_t m_seed = 0;
+
+    // PRIVATE METHODS
+    /**
+     * @brief Get the key of a cell in a hash table
+     *
+     * @param x The cell along x
+     * @param y The cell along y
+     * @param z The cell along z
+     * @return uint64_t The key of the cell
+     */
+    static uint64_t __key(int64_t x, int64_t y, int64_t z);
+    /**
+     * @brief Get the first molecule of a cell of a group
+     *
+     * @param group The group
+     * @param x The cell along x
+     * @param y The cell along y
+     * @param z The cell along z
+     * @return int The first molecule of the cell. (-1 if the cell is empty)
+     */
+    int __head(const Group &group, int64_t x, int64_t y, int64_t z) const;
+    /**
+     * @brief Add the molecules of a group placed since the last call to its cell list
+     *
+     * @param cell_size The diameter of the group
+     * @param group The group
+     */
+    void __index(float cell_size, Group &group);
+    /**
+     * @brief Check if a molecule would overlap a molecule of another diameter
+     *
+     * @param position The position of the molecule
+     * @param diameter The diameter of the molecule
+     * @return bool True if the molecule would overlap another one
+     */
+    bool __overlaps(const Coord &position, float diameter);
+
+public:
+    // PUBLIC ATTRIBUTES
+    float m_vesicle_radius = 0;
+    float m_offset = 0;
+
+    /* The largest number of cells of the array of a group, above which the cells are in a hash table */
+    static const int64_t m_MAX_CELLS = 1 << 22;
+
+    /* The relative tolerance of the overlap test, so two molecules which touch do not overlap */
+    static constexpr float m_TOLERANCE = 1e-4f;
+
+    // CONSTRUCTORS
+    Packing() = default;
+    /**
+     * @brief Construct a new Packing object
+     *
+     * @param vesicle_radius The radius of the vesicle
+     * @param offset The distance kept between the molecules and the membrane
+     * @param seed The seed of the order of the positions
+     */
+    Packing(float vesicle_radius, float offset, uint64_t seed);
+
+    // METHODS
+    /**
+     * @brief Place a molecule. Throw if there is no room left for it
+     *
+     * @param diameter The diameter of the molecule
+     * @return Coord The position of the molecule
+     */
+    Coord place(float diameter);
+};
+
+#endif // PLACEMENT_HPP
@@ -0,0 +1,169 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+/**
+ * @brief The Philox class is the Philox4x32-10 counter-based random generator.
+ *
+ * The random numbers are a function of a key and of a counter: the same key and counter always
+ * give the same 4 numbers, whatever the order they are drawn in. Each molecule can therefore
+ * have its own stream (its index) at each tick (the counter), and the numbers can be drawn in
+ * batches, or by any thread, without changing the result.
+ *
+ * @param m_key The key of the generator, made from the seed
+ */
+class Philox
+{
+public:
+    uint32_t m_key[2] = {0, 0};
+
+    // Constructors
+    Philox() = default;
+    /**
+     * @brief Construct a new Philox object
+     *
+     * @param seed The seed of the generator
+     */
+    Philox(uint64_t seed) : m_key{uint32_t(seed), uint32_t(seed >> 32)} {}
+
+    // Methods
+    /**
+     * @brief Draw the 4 random numbers of a counter
+     *
+     * @param stream The stream of the numbers
+     * @param counter The position of the numbers in the stream
+     * @param out The 4 random numbers
+     */
+    void draw(uint64_t stream, uint64_t counter, uint32_t out[4]) const
+    {
+        uint32_t c[4] = {uint32_t(counter), uint32_t(counter >> 32), uint32_t(stream), uint32_t(stream >> 32)};
+        uint32_t k[2] = {m_key[0], m_key[1]};
+
+        for (int round = 0; round < 10; round++)
+        {
+            const uint64_t p0 = uint64_t(0xD2511F53) * c[0];
+            const uint64_t p1 = uint64_t(0xCD9E8D57) * c[2];
+
+            c[0] = uint32_t(p1 >> 32) ^ c[1] ^ k[0];
+            c[1] = uint32_t(p1);
+            c[2] = uint32_t(p0 >> 32) ^ c[3] ^ k[1];
+            c[3] = uint32_t(p0);
+
+            k[0] += 0x9E3779B9;
+            k[1] += 0xBB67AE85;
+        }
+
+        out[0] = c[0];
+        out[1] = c[1];
+        out[2] = c[2];
+        out[3] = c[3];
+    }
+    /**
+     * @brief Draw the numbers of consecutive counters of a stream
+     *
+     * @param stream The stream of the numbers
+     * @param first The first counter
+     * @param count The number of counters
+     * @param out The 4 * count random numbers
+     */
+    void fill(uint64_t stream, uint64_t first, size_t count, uint32_t *out) const;
+};
+
+/**
+ * @brief The Xoshiro256 class is the xoshiro256** random generator.
+ *
+ * It is a small and fast sequential generator, usable with the distributions and the algorithms
+ * of the standard library. The streams made with jump() do not overlap.
+ *
+ * @param m_state The state of the generator
+ */
+class Xoshiro256
+{
+public:
+    using result_type = uint64_t;
+
+    uint64_t m_state[4] = {0, 0, 0, 0};
+
+    // Constructors
+    Xoshiro256() : Xoshiro256(1) {}
+    /**
+     * @brief Construct a new Xoshiro256 object
+     *
+     * @param seed The seed of the generator
+     * @param stream The stream of the generator, which jumps 2^128 numbers ahead for each stream
+     */
+    Xoshiro256(uint64_t seed, uint64_t stream = 0);
+
+    // Methods
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Draw the next random number
+     *
+     * @return result_type The random number
+     */
+    result_type operator()()
+    {
+        const uint64_t result = __rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = __rotl(m_state[3], 45);
+
+        return result;
+    }
+    /**
+     * @brief Draw a random number in [0, 1)
+     *
+     * @return double The random number
+     */
+    double uniform()
+    {
+        return ((*this)() >> 11) * 0x1.0p-53;
+    }
+    /**
+     * @brief Move the generator 2^128 numbers ahead
+     */
+    void jump();
+
+private:
+    static uint64_t __rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+/**
+ * @brief Convert a random number to a float in [0, 1)
+ *
+ * @param x The random number
+ * @return float The float
+ */
+inline float to_unit(uint32_t x)
+{
+    return (x >> 8) * 0x1.0p-24f;
+}
+
+/**
+ * @brief Mix a 64 bits number (splitmix64), used to make seeds
+ *
+ * @param x The number
+ * @return uint64_t The mixed number
+ */
+inline uint64_t mix_seed(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+#endif // RANDOM_HPP
@@ -0,0 +1,110 @@
+#ifndef RECORDER_HPP
+#define RECORDER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The Format enum represents the formats of the time series files.
+ */
+enum Format
+{
+    BINARY,
+    CSV
+};
+
+/**
+ * @brief The Recorder class streams the count of each species over time to a file.
+ *
+ * The rows are appended to a buffer by the simulation, and written by a background thread,
+ * so the simulation never waits on the disk. The binary format is:
+ *  - a header: "TERS", the version (uint32), the number of species S (uint32),
+ *    then for each species the length of its name (uint32) and its name,
+ *  - then one row per record: the tick (uint32), the time (uint64) and the S counts (uint32),
+ * in the byte order of the machine, without padding. The CSV format has a header line "tick,time,<names>".
+ *
+ * @param m_interval The number of ticks between two records
+ */
+class Recorder
+{
+private:
+    // PRIVATE ATTRIBUTES
+    FILE *m_file = nullptr;
+    Format m_format = BINARY;
+    size_t m_n_species = 0;
+
+    // The rows not written yet, filled by the simulation. The time takes 2 numbers of a row
+    std::vector<uint32_t> m_pending = std::vector<uint32_t>{};
+
+    // The error of the first write which failed. (empty if all succeeded)
+    std::string m_error = "";
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::thread m_writer;
+    bool m_stop = false;
+
+    // PRIVATE METHODS
+    /**
+     * @brief The main function of the writer thread
+     */
+    void __write();
+    /**
+     * @brief Write rows to the file
+     *
+     * @param rows The rows, of 3 + S numbers each
+     * @return bool true If the rows have been written
+     */
+    bool __write_rows(const std::vector<uint32_t> &rows);
+
+public:
+    /* The version of the binary format */
+    static const uint32_t m_VERSION = 1;
+
+    /* The number of pending numbers after which the writer is woken up */
+    static const size_t m_FLUSH_SIZE = 1 << 16;
+
+    std::string m_path = "";
+    unsigned int m_interval = 1;
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new Recorder object and write the header of the file
+     *
+     * @param path The path of the file
+     * @param format The format of the file
+     * @param names The names of the species
+     * @param interval The number of ticks between two records
+     */
+    Recorder(const std::string &path, Format format, const std::vector<std::string> &names, unsigned int interval);
+    /**
+     * @brief Write the pending rows and close the file, ignoring their error
+     */
+    ~Recorder();
+
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+
+    // METHODS
+    /**
+     * @brief Record the counts of a tick, if the tick is a multiple of the interval
+     * Throw the error of a previous write, if it failed
+     *
+     * @param tick The tick
+     * @param time The time of the simulation
+     * @param counts The count of each species
+     */
+    void record(unsigned int tick, uint64_t time, const std::vector<unsigned int> &counts);
+    /**
+     * @brief Write the pending rows, stop the writer and close the file
+     * Throw the error of a write, if one failed
+     */
+    void close();
+};
+
+#endif // RECORDER_HPP
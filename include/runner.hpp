@@ -0,0 +1,100 @@
+#ifndef RUNNER_HPP
+#define RUNNER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "simulation.hpp"
+#include "snapshot.hpp"
+
+/**
+ * @brief The Runner class steps a simulation on its own thread, and publishes its snapshots for the view.
+ *
+ * The view draws the latest snapshot at its own frame rate, and grants the runner a number of ticks
+ * at each frame with frame(). When the ticks per frame are uncapped, the simulation runs as fast as
+ * it can, and a snapshot is only taken when the view has acquired the previous one, so the copies
+ * never slow the simulation more than the frame rate. The simulation must not be used by another
+ * thread while the runner is alive.
+ *
+ * @param m_snapshots The snapshots of the simulation, read by the view
+ */
+class Runner
+{
+private:
+    // PRIVATE ATTRIBUTES
+    Simulation &m_simulation;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+    bool m_stop = false;
+
+    // The controls, and the number of ticks left to do before the next frame
+    unsigned int m_ticks_per_frame = 1;
+    bool m_uncapped = false;
+    bool m_paused = false;
+    unsigned int m_ticks_left = 0;
+
+    // PRIVATE METHODS
+    /**
+     * @brief The main function of the simulation thread
+     */
+    void __run();
+
+public:
+    // PUBLIC ATTRIBUTES
+    SnapshotBuffer m_snapshots = SnapshotBuffer();
+
+    /* The largest number of ticks per frame */
+    static constexpr unsigned int m_MAX_TICKS_PER_FRAME = 1 << 16;
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new Runner object, publish the first snapshot and start the simulation thread
+     *
+     * @param simulation The simulation, which must outlive the runner
+     */
+    Runner(Simulation &simulation);
+    /**
+     * @brief Stop the simulation thread, at the end of its current tick
+     */
+    ~Runner();
+
+    Runner(const Runner &) = delete;
+    Runner &operator=(const Runner &) = delete;
+
+    // METHODS
+    /**
+     * @brief Start a new frame: the simulation may do the ticks per frame again
+     */
+    void frame();
+    /**
+     * @brief Do a single tick, even if the simulation is paused
+     */
+    void step_once();
+    /**
+     * @brief Set the number of ticks per frame, between 1 and m_MAX_TICKS_PER_FRAME
+     *
+     * @param ticks The number of ticks per frame
+     */
+    void set_ticks_per_frame(unsigned int ticks);
+    /**
+     * @brief Let the simulation run as fast as it can, or cap it to the ticks per frame
+     *
+     * @param uncapped Run as fast as possible
+     */
+    void set_uncapped(bool uncapped);
+    /**
+     * @brief Pause or resume the simulation
+     *
+     * @param paused Pause the simulation
+     */
+    void set_paused(bool paused);
+
+    unsigned int ticks_per_frame();
+    bool uncapped();
+    bool paused();
+};
+
+#endif // RUNNER_HPP
@@ -9,157 +9,227 @@
 #include <algorithm>
 #include <random>
 #include <set>
+#include <memory>
+#include <cstdint>
 
-#include "lexer.hpp"
-#include "parser.hpp"
+#include "engine.hpp"
+#include "grid.hpp"
+#include "kernels.hpp"
+#include "molecules.hpp"
+#include "placement.hpp"
+#include "random.hpp"
+#include "thread_pool.hpp"
 #include "types.hpp"
 
-class Simulation
+/**
+ * @brief The Simulation class is the particle engine.
+ *
+ * Each molecule has a position in the vesicle and takes a random step at each tick.
+ * Two molecules react when they collide, with the probabilities of their reaction.
+ */
+class Simulation : public Engine
 {
 private:
     // PRIVATE ATTRIBUTES
-    std::vector<instr> m_instructions = std::vector<instr>{};
-    std::vector<react> m_reactions = std::vector<react>{};
-    std::map<int, std::tuple<int, int, int>> m_map_instructions = std::map<int, std::tuple<int, int, int>>{};
+    // The placement of the molecules, without overlaps. (empty once they are placed)
+    Packing m_packing = Packing();
 
-    std::vector<Coord> m_start_positions = std::vector<Coord>{};
+    // The cell list used to find the collisions
+    Grid m_grid = Grid();
+
+    // The counter-based random generator, and the moves proposed to the molecules for the current tick
+    Philox m_philox = Philox();
+    Moves m_moves = Moves();
+
+    // The threads of the parallel mode. (null in the sequential mode)
+    std::shared_ptr<ThreadPool> m_pool = nullptr;
+
+    // The molecules of each domain of the parallel mode, and the products created in each domain
+    std::vector<int> m_domain_start = std::vector<int>{};
+    std::vector<int> m_domain_molecules = std::vector<int>{};
+    std::vector<std::vector<std::pair<int, Coord>>> m_domain_products = std::vector<std::vector<std::pair<int, Coord>>>{};
 
     // PRIVATE METHODS
-    /**
-     * @brief Get the instructions from the tokenized data
-     * map<ident, <count, diameter, speed>>
-     *
-     * @param data_tokenized The tokenized data
-     * @return std::vector<instr> The instructions
-     */
-    std::map<int, std::tuple<int, int, int>> __map_instructions();
-    /**
-     * @brief Generate a random movement for a molecule
-     *
-     * @param position The current position of the molecule
-     * @param speed The speed of the molecule
-     * @return Coord The new position of the molecule
-     */
-    Coord __rand_movement(const Coord &position, float speed);
     /**
      * @brief Check if a molecule is hit by another molecule
+     * Only the molecules in the cells around the molecule are checked
      *
-     * @param m The molecule to check
+     * @param m The index of the molecule to check
      * @return int The index of the molecule that hit the molecule. -1 if no molecule hit the molecule
      */
-    int __is_hit(const Molecule &m);
+    int __is_hit(size_t m);
     /**
-     * @brief Check if two molecules are reacting
+     * @brief Check if two molecules are reacting, with the table of the reactions
      *
-     * @param molecule The first molecule
-     * @param molecule_hit The second molecule
-     * @param reaction The reaction that will be performed
-     * @return true If the two molecules are reacting
-     * @return false If the two molecules are not reacting
+     * @param molecule The index of the first molecule
+     * @param molecule_hit The index of the second molecule
+     * @return int The index of the reaction that will be performed. -1 if the molecules are not reacting
      */
-    bool __is_reacting(Molecule &molecule, Molecule &molecule_hit, react &reaction);
+    int __is_reacting(size_t molecule, size_t molecule_hit);
     /**
      * @brief Perform a reaction of fusion between two molecules
      *
-     * @param enzyme The enzyme molecule
-     * @param substrate The substrate molecule
-     * @param reaction The reaction to perform
+     * @param enzyme The index of the enzyme molecule
+     * @param substrate The index of the substrate molecule
+     * @param reaction The index of the reaction to perform
      */
-    void __reacting_fusion(Molecule &enzyme, Molecule &substrate, const react &reaction);
+    void __reacting_fusion(size_t enzyme, size_t substrate, int reaction);
     /**
      * @brief Perform a reaction of unfusion, where the enzyme molecule is separated from the substrate molecule
      * type: Es -> e + s
      *
-     * @param enzyme The enzyme molecule
-     * @param ident_product The identifier of the product molecule
+     * @param enzyme The index of the enzyme molecule
+     * @param species_product The index of the species of the product molecule
+     * @param products The products to add at the end of the tick, as <species, position>
      */
-    void __reacting_unfusion(Molecule &enzyme, const int &ident_product);
+    void __reacting_unfusion(size_t enzyme, int species_product, std::vector<std::pair<int, Coord>> &products);
 
     /**
-     * @brief Compute the distance between two coordinates
-     *
-     * @param a The first coordinate
-     * @param b The second coordinate
-     * @return float The distance between the two coordinates
+     * @brief Propose a random move to all the molecules for the current tick, with the SIMD kernels
+     * The move of a molecule only depends on the seed, the tick and the index of the molecule
      */
-    float __distance(const Coord &a, const Coord &b);
+    void __propose_moves();
     /**
-     * @brief Compute the probability of a reaction 'e: s -> p'
-     * [p1]: E + s -> Es
+     * @brief Move a molecule, and perform the reaction it takes part in
      *
-     * @param reaction The reaction to compute the probability
-     * @return float The probability of the reaction
+     * @param m The index of the molecule
+     * @param products The products to add at the end of the tick, as <species, position>
+     * @return true If the molecule took a step, which counts in the time of the simulation
+     * @return false If the molecule was skipped, has left the vesicle or has released its product
+     */
+    bool __move_molecule(size_t m, std::vector<std::pair<int, Coord>> &products);
+    /**
+     * @brief Move all the molecules with the threads of the pool
+     * The vesicle is cut into domains coloured like a 3D checkerboard with 8 colours.
+     * The domains of a colour are stepped in parallel, and the colours one after the other,
+     * so that two domains that can touch the same molecules never run at the same time.
+     * The result only depends on the seed, not on the number of threads
+     *
+     * @param products The products to add at the end of the tick, as <species, position>
      */
-    float __compute_probability_1(const react &reaction, const float &probability_2, const float &probability_3);
+    void __move_parallel(std::vector<std::pair<int, Coord>> &products);
+
     /**
-     * @brief Compute the probability of a reaction 'e: s -> p'
-     * [p2]: Es -> E + s
+     * @brief Compute the distance between two coordinates
      *
-     * @param reaction The reaction to compute the probability
-     * @return float The probability of the reaction
+     * @param a The first coordinate
+     * @param b The second coordinate
+     * @return float The distance between the two coordinates
      */
-    float __compute_probability_2(const react &reaction, const float &probability_3);
+    float __distance(const Coord &a, const Coord &b);
     /**
-     * @brief Compute the probability of a reaction 'e: s -> p'
-     * [p3]: Es -> E + p
+     * @brief Hash the diameters and the speeds of the species, and the probabilities of the reactions
+     * A state can only be loaded in a simulation with the same fingerprint
      *
-     * @param reaction The reaction to compute the probability
-     * @return float The probability of the reaction
+     * @return uint64_t The fingerprint of the model, with its overrides
      */
-    float __compute_probability_3(const react &reaction);
+    uint64_t __fingerprint() const;
 
 public:
     // PUBLIC ATTRIBUTES
-    std::vector<Molecule> m_molecules = std::vector<Molecule>{};
-    std::map<int, std::string> m_names = std::map<int, std::string>{};
-    std::vector<int> m_ident_molecules = std::vector<int>{};
+    MoleculeStore m_molecules = MoleculeStore();
 
-    const float vesicle_diameter = 620;
     float max_diameter = 0;
-    unsigned int m_time = 0;
+
+    /* The width of a domain of the parallel mode, in cells of the grid (2 at least) */
+    static const int m_DOMAIN_CELLS = 2;
+
+    /* The version of the format of the states */
+    static const uint32_t m_STATE_VERSION = 1;
 
     bool m_inverse_direction = false;
 
+    // CONSTRUCTORS
+    Simulation() = default;
+    /**
+     * @brief Construct a copy of a simulation
+     * The copy has its own threads, so the two simulations can step at the same time
+     *
+     * @param other The simulation to copy
+     */
+    Simulation(const Simulation &other);
+
     // PUBLIC METHODS
+    using Engine::init;
     /**
      * @brief Initialize the simulation
      *
-     * @param data_path The path to the data file
+     * @param model The parsed model
      */
-    void init(char *data_path);
+    void init(std::shared_ptr<const Model> model) override;
     /**
      * Initialize the maximum diameter of the molecules
      */
     void init_max_diameter();
     /**
-     * Initialize the count of the molecules and the types of molecules
-     */
-    void init_count_molecules();
-    /**
-     * Initialize the equidistant positions of the molecules
+     * Initialize the placement of the molecules: the molecules of each diameter are equidistant,
+     * and drawn in a random order when they are placed
      */
     void init_equidistant_positions();
     /**
-     * Initialize the molecules
+     * Initialize the molecules, placed from the largest to the smallest without overlaps
      */
     void init_molecules();
     /**
-     * Initialize the reactions
+     * Initialize the probabilities of the reactions, with the overrides of the run
      */
     void init_reactions();
+    /**
+     * Initialize the cell list used to find the collisions
+     */
+    void init_grid();
     /**
      * @brief Move all the molecules in the simulation
      */
     void move_all_molecules();
+    /**
+     * @brief Advance the simulation by one tick, by moving all the molecules
+     */
+    void step() override;
+    /**
+     * @brief Check if there is no molecule left to move
+     *
+     * @return true If the vesicle is empty
+     */
+    bool is_idle() const override;
+    /**
+     * @brief Set the number of threads used to move the molecules
+     * With 0, the molecules are moved one after the other in the sequential mode.
+     * Otherwise, the parallel mode is used, whose result does not depend on the number of threads
+     *
+     * @param threads The number of threads
+     */
+    void set_threads(unsigned int threads);
 
     /**
-     * @brief Read the file and parse it, to get the instructions and reactions of the simulation
+     * @brief Copy the state of the simulation to a buffer, to continue it later with load_state()
+     * The state is the molecules, their bound reactions and flags, the counts, the tick, the time,
+     * the direction of the next tick and the seed: the random numbers only depend on the seed and the tick.
+     * The format is "TERC", the version (uint32), the number of species and of reactions (uint32),
+     * the fingerprint of the model and the seed (uint64), the tick and the direction (uint32), the time and
+     * the number of molecules (uint64), the counts (uint32), then each array of the molecules, in the byte
+     * order of the machine
      *
-     * @param data_path The path to the data file
+     * @param buffer The buffer, replaced by the state
      */
-    void read_file(char *data_path);
+    void save_state(std::vector<char> &buffer) const;
+    /**
+     * @brief Continue a simulation from a state saved by save_state()
+     * The simulation must be initialized with the same model and overrides. The continuation is the same,
+     * bit for bit, as the simulation which saved the state, in the sequential and in the parallel mode
+     *
+     * @param data The state
+     * @param size The size of the state
+     */
+    void load_state(const char *data, size_t size);
 
     // OPERATORS
+    /**
+     * @brief Copy a simulation
+     * The thread pool is not shared: a pool of the same size is created, as a pool runs one loop at a time
+     *
+     * @param other The simulation to copy
+     */
     Simulation &operator=(const Simulation &other);
 };
 
@@ -0,0 +1,161 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <atomic>
+#include <vector>
+
+#include "simulation.hpp"
+
+/**
+ * @brief The Bucket struct is a run of the molecules of a snapshot, of the same species in the same cell.
+ *
+ * @param cell The index of the cell
+ * @param species The index of the species
+ * @param start The index of the first molecule
+ * @param count The number of molecules
+ * @param x The mean x position of the molecules
+ * @param y The mean y position of the molecules
+ * @param z The mean z position of the molecules
+ */
+struct Bucket
+{
+    int cell;
+    int species;
+    unsigned int start;
+    unsigned int count;
+    float x, y, z;
+};
+
+/**
+ * @brief The Snapshot class is a copy of what is drawn of the simulation at the end of a tick.
+ *
+ * The molecules are sorted by the cells of a coarse grid over the vesicle, then by species, so the
+ * molecules of a species in a cell are contiguous: the view culls and simplifies them by bucket,
+ * and draws the ranges which are left without copying them.
+ *
+ * @param m_x The x position of the molecules
+ * @param m_y The y position of the molecules
+ * @param m_z The z position of the molecules
+ * @param m_diameter The diameter of the molecules
+ * @param m_species The index of the species of the molecules in the species table
+ * @param m_counts The number of molecules of each species
+ * @param m_tick The tick of the simulation
+ * @param m_time The time of the simulation
+ * @param m_cells The number of cells of the grid in each direction
+ * @param m_cell_size The size of the cells
+ * @param m_origin The lowest coordinate of the grid
+ * @param m_buckets The buckets which are not empty, sorted by cell then by species
+ */
+class Snapshot
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The bucket of each molecule of the simulation, and the first molecule of each bucket
+    std::vector<unsigned int> m_keys = std::vector<unsigned int>{};
+    std::vector<unsigned int> m_key_start = std::vector<unsigned int>{};
+
+public:
+    // ATTRIBUTES
+    std::vector<float> m_x = std::vector<float>{};
+    std::vector<float> m_y = std::vector<float>{};
+    std::vector<float> m_z = std::vector<float>{};
+    std::vector<float> m_diameter = std::vector<float>{};
+    std::vector<int> m_species = std::vector<int>{};
+    std::vector<unsigned int> m_counts = std::vector<unsigned int>{};
+
+    unsigned int m_tick = 0;
+    uint64_t m_time = 0;
+
+    int m_cells = 1;
+    float m_cell_size = 0;
+    float m_origin = 0;
+    std::vector<Bucket> m_buckets = std::vector<Bucket>{};
+
+    /* The number of cells of the grid in each direction, fewer if the species are too many */
+    static constexpr int m_CELLS = 16;
+
+    /* The maximum number of buckets, cells times species */
+    static const int m_MAX_BUCKETS = 1 << 18;
+
+    // METHODS
+    /**
+     * @brief Copy the state of a simulation, sorted by bucket. The memory of the previous copy is reused
+     *
+     * @param simulation The simulation
+     */
+    void capture(const Simulation &simulation);
+    /**
+     * @brief Get the number of molecules
+     *
+     * @return size_t The number of molecules
+     */
+    size_t size() const;
+    /**
+     * @brief Get the bounds of a cell
+     *
+     * @param cell The index of the cell
+     * @param low The lowest corner of the cell
+     * @param high The highest corner of the cell
+     */
+    void cell_bounds(int cell, float low[3], float high[3]) const;
+};
+
+/**
+ * @brief The SnapshotBuffer class passes the snapshots from the simulation thread to the view, without locks.
+ *
+ * It is a triple buffer: the writer fills the back snapshot and swaps it with the middle one, and
+ * the reader swaps the middle snapshot with its front one when a new snapshot has been published.
+ * The swaps are a single atomic exchange, so neither thread ever waits for the other, and the
+ * reader always gets the latest snapshot, the older ones being dropped.
+ * There must be one writer thread and one reader thread.
+ */
+class SnapshotBuffer
+{
+private:
+    // PRIVATE ATTRIBUTES
+    Snapshot m_snapshots[3];
+
+    // The index of the middle snapshot, with m_FRESH when it has been published and not acquired yet
+    std::atomic<unsigned int> m_middle{1};
+
+    // The snapshot filled by the writer, and the one read by the reader
+    unsigned int m_back = 0;
+    unsigned int m_front = 2;
+
+public:
+    /* The bit set on the middle index when it holds a new snapshot */
+    static const unsigned int m_FRESH = 4;
+
+    // METHODS
+    /**
+     * @brief Get the snapshot to fill, by the writer
+     *
+     * @return Snapshot& The back snapshot
+     */
+    Snapshot &back();
+    /**
+     * @brief Publish the back snapshot, by the writer
+     */
+    void publish();
+    /**
+     * @brief Check if the last published snapshot has been acquired by the reader
+     *
+     * @return true If the reader is waiting for a new snapshot
+     */
+    bool consumed() const;
+    /**
+     * @brief Take the latest published snapshot as the front snapshot, by the reader
+     *
+     * @return true If a new snapshot has been acquired
+     * @return false If nothing has been published since the last call
+     */
+    bool acquire();
+    /**
+     * @brief Get the snapshot to draw, by the reader
+     *
+     * @return const Snapshot& The front snapshot
+     */
+    const Snapshot &front() const;
+};
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,118 @@
+#ifndef SPLATTER_HPP
+#define SPLATTER_HPP
+
+#include <tuple>
+#include <vector>
+
+#include "snapshot.hpp"
+
+/**
+ * @brief The Splatter class draws the molecules and the vesicle on the CPU, without OpenGL nor display.
+ *
+ * The camera is the one of the view: 45 degrees of field of view, looking at the center of the
+ * vesicle from a distance, after the rotations of the mouse. Each molecule is splatted as a disc
+ * shaded as a sphere, like the point sprites of the view, with a depth buffer, and the vesicle is
+ * drawn as a transparent wire sphere. The image is in RGB, 8 bits per channel, from the top row.
+ *
+ * @param m_width The width of the image, in pixels
+ * @param m_height The height of the image, in pixels
+ * @param m_camera_distance The distance of the camera from the center of the vesicle
+ * @param m_rotate_x The rotation of the vesicle around the x axis, in degrees
+ * @param m_rotate_y The rotation of the vesicle around the y axis, in degrees
+ * @param m_vesicle_radius The radius of the vesicle
+ */
+class Splatter
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The color of each species, and the distance of the nearest surface at each pixel
+    std::vector<std::tuple<float, float, float>> m_colors = std::vector<std::tuple<float, float, float>>{};
+    std::vector<float> m_depth = std::vector<float>{};
+
+    // The rotation of the vesicle, and the focal length in pixels
+    float m_rotation[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    float m_focal = 0;
+
+    // PRIVATE METHODS
+    /**
+     * @brief Compute the rotation and the focal length from the camera
+     */
+    void __init_camera();
+    /**
+     * @brief Project a point of the vesicle to the image
+     *
+     * @param x The x coordinate of the point
+     * @param y The y coordinate of the point
+     * @param z The z coordinate of the point
+     * @param screen The column, the row and the distance to the camera of the point
+     * @return true If the point is in front of the camera
+     */
+    bool __project(float x, float y, float z, float screen[3]) const;
+    /**
+     * @brief Splat the molecules of a snapshot
+     *
+     * @param snapshot The snapshot
+     * @param image The image
+     */
+    void __draw_molecules(const Snapshot &snapshot, std::vector<unsigned char> &image);
+    /**
+     * @brief Blend the lines of the wire sphere of the vesicle, where they are in front of the molecules
+     *
+     * @param image The image
+     */
+    void __draw_vesicle(std::vector<unsigned char> &image) const;
+    /**
+     * @brief Blend a line of the vesicle, pixel by pixel
+     *
+     * @param from The projection of the start of the line
+     * @param to The projection of the end of the line
+     * @param image The image
+     */
+    void __blend_line(const float from[3], const float to[3], std::vector<unsigned char> &image) const;
+
+public:
+    // PUBLIC ATTRIBUTES
+    int m_width = 1000, m_height = 900;
+
+    float m_camera_distance = 1000;
+    float m_rotate_x = 0, m_rotate_y = 0;
+    float m_vesicle_radius = 620 / 2;
+
+    /* The detail of the wire sphere of the vesicle, as in the view */
+    static const int m_SLICES = 50;
+    static const int m_STACKS = 10;
+
+    /* The gray of the background, and the opacity of the vesicle */
+    static constexpr unsigned char m_BACKGROUND = 35;
+    static constexpr float m_VESICLE_ALPHA = 0.1;
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new Splatter object
+     *
+     * @param width The width of the image, in pixels
+     * @param height The height of the image, in pixels
+     * @param n_species The number of species, whose colors are taken from the palette
+     */
+    Splatter(int width, int height, size_t n_species);
+
+    // METHODS
+    /**
+     * @brief Draw a snapshot
+     *
+     * @param snapshot The snapshot
+     * @param image The image, replaced by the drawing
+     */
+    void render(const Snapshot &snapshot, std::vector<unsigned char> &image);
+
+    /**
+     * @brief Get the color of a species: the species are spread on a lattice of the RGB cube, without black
+     *
+     * @param species The index of the species
+     * @param n_species The number of species
+     * @return std::tuple<float, float, float> The color, each channel between 0 and 1
+     */
+    static std::tuple<float, float, float> palette(size_t species, size_t n_species);
+};
+
+#endif // SPLATTER_HPP
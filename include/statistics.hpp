@@ -0,0 +1,83 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include <cstddef>
+
+/**
+ * @brief The RunningStats class computes the mean and the variance of a series of numbers online,
+ * with the algorithm of Welford, without storing the numbers.
+ *
+ * @param m_count The number of numbers added
+ * @param m_mean The mean of the numbers
+ * @param m_m2 The sum of the squared differences to the mean
+ */
+class RunningStats
+{
+public:
+    size_t m_count = 0;
+    double m_mean = 0;
+    double m_m2 = 0;
+
+    // METHODS
+    /**
+     * @brief Add a number to the series
+     *
+     * @param x The number
+     */
+    void add(double x);
+    /**
+     * @brief Get the sample variance of the numbers
+     *
+     * @return double The variance. (0 with less than 2 numbers)
+     */
+    double variance() const;
+};
+
+/**
+ * @brief The P2Quantile class estimates a quantile of a series of numbers online,
+ * with the P² algorithm of Jain and Chlamtac, in constant memory.
+ *
+ * Five markers follow the minimum, the quantiles p / 2, p, (1 + p) / 2 and the maximum,
+ * and their heights are moved with a parabolic interpolation as the numbers arrive.
+ *
+ * @param m_p The quantile to estimate, in [0, 1]
+ * @param m_count The number of numbers added
+ */
+class P2Quantile
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The heights of the markers, their positions, their desired positions and the increments of the desired positions
+    double m_heights[5] = {0, 0, 0, 0, 0};
+    double m_positions[5] = {1, 2, 3, 4, 5};
+    double m_desired[5] = {0, 0, 0, 0, 0};
+    double m_increments[5] = {0, 0, 0, 0, 0};
+
+public:
+    double m_p = 0.5;
+    size_t m_count = 0;
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new P2Quantile object
+     *
+     * @param p The quantile to estimate, in [0, 1]
+     */
+    P2Quantile(double p = 0.5);
+
+    // METHODS
+    /**
+     * @brief Add a number to the series
+     *
+     * @param x The number
+     */
+    void add(double x);
+    /**
+     * @brief Get the estimate of the quantile
+     *
+     * @return double The quantile. (0 if no number has been added)
+     */
+    double value() const;
+};
+
+#endif // STATISTICS_HPP
@@ -0,0 +1,134 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdio>
+#include <cstdint>
+
+#include "engine.hpp"
+#include "model.hpp"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+/**
+ * @brief The Axis struct represents a parameter scanned by a sweep.
+ *
+ * @param parameter The parameter
+ * @param target The index of the reaction, or the id of the species
+ * @param label The name of the parameter in the result table
+ * @param values The values of the parameter, for a grid
+ * @param min The smallest value of the parameter, for a Latin hypercube
+ * @param max The largest value of the parameter, for a Latin hypercube
+ */
+struct Axis
+{
+    Parameter parameter;
+    int target = 0;
+    std::string label = "";
+
+    std::vector<float> values = std::vector<float>{};
+    float min = 0, max = 0;
+};
+
+/**
+ * @brief The Sweep class runs a model for many values of its parameters, and gathers the results in one table.
+ *
+ * The sweep file has one axis per line, after a line 'grid' or 'lhs <samples>':
+ *     grid
+ *     kcat 0 50 100 200
+ *     diametre E1 0.5 1 2
+ * runs every combination of the values (a full grid), while
+ *     lhs 64
+ *     kcat 0 50 200
+ *     mM 1 0.1 0.5
+ * draws 64 points in the ranges with a Latin hypercube. The reactions are given by their index in the
+ * model, and the species by their name. The parameters are kcat, mM, diametre and vitesse, in the units
+ * of the model files. Lines starting with '#' are comments.
+ *
+ * The model is parsed once and shared by all the runs, which only carry their overrides.
+ * The runs are scheduled on the threads of a pool with work stealing: each thread has its own
+ * queue of runs, and takes the runs at the back of the queue of another thread when its queue is empty.
+ *
+ * @param m_axes The scanned parameters
+ * @param m_points The values of the parameters of each run
+ * @param m_results The final count of each species of each run
+ */
+class Sweep
+{
+private:
+    // PRIVATE ATTRIBUTES
+    std::shared_ptr<const Model> m_model = nullptr;
+
+    // Creates the engine of a run
+    std::function<std::unique_ptr<Engine>()> m_make_engine;
+
+    // The number of points of the Latin hypercube. (0 for a grid)
+    unsigned int m_samples = 0;
+
+    // Set by the first run which ends, with the names of the species
+    std::once_flag m_names_once;
+
+    // PRIVATE METHODS
+    /**
+     * @brief Run the model with the parameters of a point
+     *
+     * @param point The index of the point
+     * @param seed The seed of the sweep
+     */
+    void __run_point(size_t point, uint64_t seed);
+
+public:
+    // PUBLIC ATTRIBUTES
+    std::vector<Axis> m_axes = std::vector<Axis>{};
+    std::vector<std::vector<float>> m_points = std::vector<std::vector<float>>{};
+    std::vector<std::vector<unsigned int>> m_results = std::vector<std::vector<unsigned int>>{};
+
+    // The names of the species, known after the first run
+    std::vector<std::string> m_names = std::vector<std::string>{};
+
+    unsigned long m_ticks = 0;
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new Sweep object
+     *
+     * @param model The parsed model
+     * @param make_engine The function which creates the engine of a run
+     * @param ticks The number of ticks of each run
+     */
+    Sweep(std::shared_ptr<const Model> model, std::function<std::unique_ptr<Engine>()> make_engine, unsigned long ticks);
+
+    Sweep(const Sweep &) = delete;
+    Sweep &operator=(const Sweep &) = delete;
+
+    // METHODS
+    /**
+     * @brief Read the sweep file, and make the points of the sweep
+     *
+     * @param path The path to the sweep file
+     * @param seed The seed of the Latin hypercube
+     */
+    void read_file(const char *path, uint64_t seed);
+    /**
+     * @brief Run all the points on the threads of a pool
+     * The seed of the run of the point 'p' is made from the seed and 'p'.
+     * If a run fails, the points not started yet are skipped and the error is thrown
+     *
+     * @param seed The seed of the runs
+     * @param pool The threads to use
+     */
+    void run(uint64_t seed, ThreadPool &pool);
+    /**
+     * @brief Write the results as a CSV table, with one line per run:
+     * the index of the run, the value of each parameter, then the final count of each species
+     *
+     * @param fp The file to write to
+     */
+    void write(FILE *fp) const;
+};
+
+#endif // SWEEP_HPP
@@ -0,0 +1,117 @@
+#ifndef TAU_LEAPING_HPP
+#define TAU_LEAPING_HPP
+
+#include <vector>
+#include <utility>
+
+#include "gillespie.hpp"
+
+/**
+ * @brief The TauLeaping class is the approximate well-mixed engine, for the models with many molecules.
+ *
+ * Instead of firing the reactions one by one, each channel fires a Poisson number of times
+ * over a leap of time tau, with the rates of the Gillespie engine. Tau is chosen so that no rate
+ * changes by more than a fraction epsilon of itself (Cao, Gillespie and Petzold, 2006), and a leap
+ * which makes a count negative is tried again with half the step. When tau is smaller than a few
+ * reactions, the engine fires the next reactions one by one with the exact SSA instead.
+ *
+ * The implicit mode is meant for the stiff models, where the binding and the release of the substrate
+ * are much faster than the catalysis: the leap is solved at the end of the step with Newton's method,
+ * and the pairs of channels in partial equilibrium are left out of the choice of tau.
+ *
+ * @param m_epsilon The error parameter, the largest relative change of a rate in a leap
+ * @param m_implicit Use the implicit mode
+ * @param m_leaps The number of leaps done
+ */
+class TauLeaping : public Gillespie
+{
+private:
+    // PRIVATE ATTRIBUTES
+    // The changes of the quantities made by each channel, as <quantity, change>, in a flat list
+    std::vector<int> m_changes_start = std::vector<int>{};
+    std::vector<std::pair<int, int>> m_changes = std::vector<std::pair<int, int>>{};
+
+    // The quantities read by each channel, and the highest order of the channels which read each quantity
+    std::vector<std::vector<int>> m_reactants = std::vector<std::vector<int>>{};
+    std::vector<int> m_orders = std::vector<int>{};
+
+    // PRIVATE METHODS
+    /**
+     * @brief Get the quantities of the engine: the free molecules of each species, then the bound enzymes of each reaction
+     *
+     * @param quantities The quantities
+     */
+    void __quantities(std::vector<double> &quantities) const;
+    /**
+     * @brief Compute the rate of a channel for some quantities
+     *
+     * @param channel The index of the channel
+     * @param quantities The quantities
+     * @return double The rate of the channel, per tick
+     */
+    double __rate_of(int channel, const std::vector<double> &quantities) const;
+    /**
+     * @brief Choose the largest leap which keeps the change of the rates under epsilon
+     *
+     * @param quantities The quantities
+     * @param rates The rate of each channel
+     * @return double The leap. (infinite if nothing limits it)
+     */
+    double __select_tau(const std::vector<double> &quantities, const std::vector<double> &rates) const;
+    /**
+     * @brief Solve the quantities at the end of an implicit leap with Newton's method
+     *
+     * @param quantities The quantities at the start of the leap
+     * @param rates The rate of each channel at the start of the leap
+     * @param firings The Poisson numbers drawn for each channel
+     * @param tau The leap
+     * @param solution The quantities at the end of the leap
+     */
+    void __solve_implicit(const std::vector<double> &quantities, const std::vector<double> &rates,
+                          const std::vector<double> &firings, double tau, std::vector<double> &solution) const;
+    /**
+     * @brief Fire all the channels over a leap
+     *
+     * @param quantities The quantities
+     * @param rates The rate of each channel
+     * @param tau The leap
+     * @return true If the leap has been done
+     * @return false If the leap would make a count negative, and has not been done
+     */
+    bool __leap(const std::vector<double> &quantities, const std::vector<double> &rates, double tau);
+
+public:
+    // PUBLIC ATTRIBUTES
+    double m_epsilon = 0.03;
+    bool m_implicit = false;
+
+    unsigned int m_leaps = 0;
+
+    /* The exact SSA is used when tau is shorter than this number of reactions */
+    static const int m_SSA_THRESHOLD = 10;
+
+    /* The number of reactions fired with the exact SSA before trying to leap again */
+    static const int m_SSA_REACTIONS = 100;
+
+    /* The relative difference under which the rates of a reversible pair are in partial equilibrium */
+    static constexpr double m_EQUILIBRIUM = 0.05;
+
+    // PUBLIC METHODS
+    using Engine::init;
+    /**
+     * @brief Initialize the engine
+     *
+     * @param model The parsed model
+     */
+    void init(std::shared_ptr<const Model> model) override;
+    /**
+     * Initialize the changes made by each channel, and the quantities it reads
+     */
+    void init_stoichiometry();
+    /**
+     * @brief Leap until the next tick
+     */
+    void step() override;
+};
+
+#endif // TAU_LEAPING_HPP
@@ -0,0 +1,86 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The ThreadPool class runs loops of independent tasks on a fixed set of threads.
+ *
+ * The threads are created once and sleep between two loops.
+ * The calling thread takes part in the loop, so a pool of 1 thread creates no thread.
+ * The first exception thrown by a task stops the loop, and is thrown again by parallel_for.
+ *
+ * @param m_workers The threads of the pool, without the calling thread
+ */
+class ThreadPool
+{
+private:
+    // PRIVATE ATTRIBUTES
+    std::vector<std::thread> m_workers = std::vector<std::thread>{};
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    // The current loop
+    const std::function<void(size_t)> *m_task = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next{0};
+    // The first exception thrown by a task of the current loop
+    std::exception_ptr m_error = nullptr;
+
+    // The number of workers still running the current loop
+    unsigned int m_active = 0;
+    // Incremented for each new loop, to wake up the workers
+    unsigned int m_generation = 0;
+    bool m_stop = false;
+
+    // PRIVATE METHODS
+    /**
+     * @brief The main function of a worker
+     */
+    void __work();
+    /**
+     * @brief Run the tasks of the current loop until there is no more task
+     */
+    void __run_tasks();
+
+public:
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new ThreadPool object
+     *
+     * @param threads The number of threads, including the calling thread. (0 for the number of cores)
+     */
+    ThreadPool(unsigned int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // METHODS
+    /**
+     * @brief Get the number of threads, including the calling thread
+     *
+     * @return unsigned int The number of threads
+     */
+    unsigned int size() const;
+    /**
+     * @brief Run task(0) ... task(count - 1) on the threads of the pool, and wait for all of them
+     * The tasks can be run in any order, and must not depend on each other.
+     * If a task throws, the tasks not started yet are skipped, and the first exception is thrown again
+     *
+     * @param count The number of tasks
+     * @param task The task to run
+     */
+    void parallel_for(size_t count, const std::function<void(size_t)> &task);
+};
+
+#endif // THREAD_POOL_HPP
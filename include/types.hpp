@@ -43,22 +43,25 @@ struct UL
 /**
  * @brief The react struct represents a reaction.
  *
+ * The ids are the indices of the lexer table after parsing, and the indices of the species table
+ * once the simulation is initialized.
+ *
  * @param ident The id of the enzyme
- * @param substrates The substrates represented by their id. (0 if not present)
- * @param products The products represented by their id. (0 if not present)
+ * @param substrates The substrates represented by their id. (-1 if not present)
+ * @param products The products represented by their id. (-1 if not present)
  * @param mM The quantity in mM of sub_1 and sub_2.
  * @param kcat The kcat of the enzyme
  */
 struct react
 {
     // The id of the enzyme
-    float ident = -1;
+    int ident = -1;
 
     // The substrate represented by their id. (-1 if not present)
-    float substrate = -1;
+    int substrate = -1;
 
     // The product represented by their id. (-1 if not present)
-    float product = -1;
+    int product = -1;
 
     // The quantity in mM of sub.
     float mM = 0;
@@ -79,7 +82,8 @@ struct instr
 {
     Keyword type;
 
-    float ident = 0, value = 0;
+    int ident = 0;
+    float value = 0;
 };
 
 // Classe des coordonnées d'une molécule
@@ -122,52 +126,39 @@ struct Coord
 };
 
 /**
- * @brief The Molecule struct represents a molecule.
+ * @brief The Override struct represents a new value of a parameter of a model, for a run.
  *
- * @param ident The type identifier of the molecule
- * @param diameter The diameter of the molecule
- * @param speed The speed of the molecule
- * @param x The x position of the molecule
- * @param y The y position of the molecule
- * @param z The z position of the molecule
- * @param is_seen Boolean to check if the molecule has been seen
- * @param next Pointer to the next molecule in the same zone
- * @param prev Pointer to the prev molecule in the same zone
+ * @param parameter The parameter to change
+ * @param target The index of the reaction for KCAT and MM, the id of the species for DIAMETER_OF and SPEED_OF
+ * @param value The new value, in the units of the model files
  */
-struct Molecule
+struct Override
 {
-    // The type identifier of the molecule
-    int ident = 0;
+    Parameter parameter;
 
-    // The name of the molecule
-    std::string name = "";
+    int target = 0;
+    float value = 0;
+};
 
-    // The ident of the molecule that the molecule will fuse with
-    react reaction = {};
+/**
+ * @brief The Species struct represents a type of molecule.
+ * The data shared by all the molecules of a type is stored once here.
+ *
+ * @param ident The identifier of the species in the lexer table, and of its name in the names of the model
+ * @param diameter The diameter of the molecules of this species
+ * @param speed The speed of the molecules of this species
+ * @param count The initial number of molecules of this species
+ */
+struct Species
+{
+    // The identifier of the species in the lexer table
+    int ident = 0;
 
-    // The diameter and speed of the molecule
+    // The diameter and speed of the molecules
     float diameter = 1, speed = 1;
 
-    // Position of the molecule with class Coord
-    Coord position;
-
-    // Boolean to check if the molecule has been seen
-    bool is_seen = false;
-
-    // Boolean to delete the molecule
-    bool to_delete = false;
-
-    // Pointer to the next and prev molecule in the same zone
-    Molecule *next = 0, *prev = 0;
-
-    // Constructors
-    Molecule() = default;
-    /**
-     * @brief Construct a new Molecule object
-     *
-     * @param ident The type identifier of the molecule
-     */
-    Molecule(int ident) : ident(ident) {}
+    // The initial number of molecules
+    int count = 0;
 };
 
 #endif
@@ -0,0 +1,137 @@
+#ifndef VIDEO_HPP
+#define VIDEO_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulation.hpp"
+#include "snapshot.hpp"
+#include "splatter.hpp"
+
+/**
+ * @brief The VideoFormat enum represents the outputs of the video.
+ */
+enum VideoFormat
+{
+    PNG_FRAMES,
+    Y4M_STREAM
+};
+
+/**
+ * @brief The VideoWriter class renders the frames of a simulation without display, and encodes them in the background.
+ *
+ * The simulation only copies its molecules to a snapshot, and goes on at once: the frames are splatted
+ * on the CPU and encoded by an encoder thread. The snapshots come from a small pool, so the simulation
+ * only waits when the encoder is m_POOL_SIZE frames behind, which bounds the memory.
+ * The output depends on the path:
+ *  - a path with a printf pattern of the frame index, like frames/%06d.png, writes a PNG file by frame,
+ *  - a path ending with .y4m writes a raw YUV 4:2:0 stream (YUV4MPEG2), "-" writes it to the standard output,
+ *  - a path starting with | pipes the stream to a command, for example "|ffmpeg -i - run.mp4".
+ *
+ * @param m_path The path of the output
+ * @param m_format The format of the output
+ * @param m_frames The number of frames encoded
+ */
+class VideoWriter
+{
+private:
+    // PRIVATE ATTRIBUTES
+    Splatter m_splatter;
+
+    // The stream of the YUV frames. (null for the PNG frames)
+    FILE *m_stream = nullptr;
+    bool m_pipe = false;
+    int m_fps = 30;
+
+    // The pool of the snapshots, the snapshots free to be filled, and those waiting for the encoder
+    std::vector<Snapshot> m_snapshots = std::vector<Snapshot>{};
+    std::vector<int> m_free = std::vector<int>{};
+    std::deque<int> m_queue = std::deque<int>{};
+
+    // The error of the last frame. (empty if it succeeded)
+    std::string m_error = "";
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_freed;
+    std::thread m_encoder;
+    bool m_stop = false;
+
+    // The image of the frame, and its encoding, used by the encoder
+    std::vector<unsigned char> m_image = std::vector<unsigned char>{};
+    std::vector<unsigned char> m_encoded = std::vector<unsigned char>{};
+
+    // PRIVATE METHODS
+    /**
+     * @brief The main function of the encoder thread
+     */
+    void __encode();
+    /**
+     * @brief Render a snapshot and write its frame
+     *
+     * @param snapshot The snapshot
+     * @return std::string The error. (empty if the frame has been written)
+     */
+    std::string __write_frame(const Snapshot &snapshot);
+    /**
+     * @brief Write the image to a PNG file
+     *
+     * @return std::string The error. (empty if the file has been written)
+     */
+    std::string __write_png();
+    /**
+     * @brief Convert the image to YUV 4:2:0 and write it to the stream
+     *
+     * @return std::string The error. (empty if the frame has been written)
+     */
+    std::string __write_y4m();
+
+public:
+    std::string m_path = "";
+    VideoFormat m_format = PNG_FRAMES;
+
+    unsigned int m_frames = 0;
+
+    /* The number of snapshots, the most frames the encoder can be behind the simulation */
+    static const int m_POOL_SIZE = 4;
+
+    // CONSTRUCTORS
+    /**
+     * @brief Construct a new VideoWriter object, open the output and start the encoder
+     *
+     * @param path The path of the output
+     * @param width The width of the frames, in pixels. (even for the YUV stream)
+     * @param height The height of the frames, in pixels. (even for the YUV stream)
+     * @param n_species The number of species of the simulation
+     * @param fps The number of frames per second of the YUV stream
+     */
+    VideoWriter(const std::string &path, int width, int height, size_t n_species, int fps = 30);
+    /**
+     * @brief Encode the pending frames and close the output
+     */
+    ~VideoWriter();
+
+    VideoWriter(const VideoWriter &) = delete;
+    VideoWriter &operator=(const VideoWriter &) = delete;
+
+    // METHODS
+    /**
+     * @brief Copy the molecules of a simulation, and encode their frame in the background
+     * Throw the error of a previous frame, if it failed
+     *
+     * @param simulation The simulation
+     */
+    void submit(const Simulation &simulation);
+    /**
+     * @brief Encode the pending frames, close the output and stop the encoder
+     * Throw the error of a frame, if one failed
+     */
+    void close();
+};
+
+#endif // VIDEO_HPP
@@ -3,10 +3,33 @@
 
 #include <vector>
 #include <tuple>
-#include <map>
+#include <string>
+#include <memory>
+
+// The functions of OpenGL 2.0 (buffers and shaders) are declared by the headers
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
 #include <GL/glut.h>
 
+#include "runner.hpp"
 #include "simulation.hpp"
+#include "snapshot.hpp"
+#include "splatter.hpp"
+
+/**
+ * @brief The SpeciesRender struct is the row of a species in the render table of the view.
+ *
+ * @param color The color of the species, each channel between 0 and 1
+ * @param label The text of the species in the legend, its name and its count
+ * @param count The count shown by the label
+ */
+struct SpeciesRender
+{
+    std::tuple<float, float, float> color = {1, 1, 1};
+    std::string label = "";
+    unsigned int count = 0;
+};
 
 class View
 {
@@ -21,8 +44,39 @@ private:
     // The distance of the camera from the vesicle
     float __m_camera_distance = 100;
 
-    // Map colors for each molecule type
-    std::map<int, std::tuple<float, float, float>> m_colors;
+    // The render table of the species, by index in the species table
+    std::vector<SpeciesRender> m_species_render = std::vector<SpeciesRender>{};
+
+    // The display list of the species in the legend, compiled again when a count changes. (0 before the first frame)
+    GLuint m_legend_list = 0;
+    bool m_legend_changed = true;
+
+    // The point sprite renderer: the shader program, a buffer for each attribute of the molecules
+    // (x, y, z, diameter and species), and the texture of the colors of the species. (0 if not supported)
+    GLuint m_program = 0;
+    GLuint m_buffers[5] = {0, 0, 0, 0, 0};
+    GLuint m_color_texture = 0;
+
+    // The program and the buffer of the density impostors, and whether the buffers hold the front snapshot
+    GLuint m_impostor_program = 0;
+    GLuint m_impostor_buffer = 0;
+    bool m_uploaded = false;
+
+    // The camera of the frame: the planes of the frustum (a, b, c, d), the position of the camera
+    // in the space of the vesicle, and the size of an object of width 1 at a distance of 1, in pixels
+    float m_planes[6][4] = {};
+    float m_camera[3] = {0, 0, 0};
+    float m_focal = 1;
+
+    // The ranges of molecules drawn as spheres and as points, and the impostors (x, y, z, size, r, g, b, a)
+    std::vector<GLint> m_sphere_first = std::vector<GLint>{};
+    std::vector<GLsizei> m_sphere_count = std::vector<GLsizei>{};
+    std::vector<GLint> m_point_first = std::vector<GLint>{};
+    std::vector<GLsizei> m_point_count = std::vector<GLsizei>{};
+    std::vector<float> m_impostors = std::vector<float>{};
+
+    // The thread stepping the simulation, whose snapshots are drawn. (null before the window is created)
+    std::unique_ptr<Runner> m_runner = nullptr;
 
     // PRIVATE METHODS
     /**
@@ -33,15 +87,63 @@ private:
     void __set_simulation(const Simulation &simulation);
 
     /**
-     * @brief Map the colors of the molecules
+     * @brief Build the render table of the species: their color, from the palette shared with the videos, and their label
+     *
+     */
+    void __init_render_table();
+    /**
+     * @brief Update the labels of the species whose count has changed, and compile the display list of the legend again if one did
+     *
+     * @param snapshot The snapshot drawn
+     */
+    void __update_legend(const Snapshot &snapshot);
+    /**
+     * @brief Compile the shaders of the point sprite renderer, and create its buffers
+     * The renderer is left disabled if OpenGL 2.0 or the shaders are not supported
+     *
+     */
+    void __init_renderer();
+    /**
+     * @brief Upload the colors of the species to the texture of the renderer
+     *
+     */
+    void __upload_colors();
+    /**
+     * @brief Compute the frustum and the position of the camera from the matrices of OpenGL
+     *
+     */
+    void __init_frame();
+    /**
+     * @brief Cull the cells of a snapshot outside of the frustum, and choose how to draw each bucket of the others:
+     * as spheres, as points, or aggregated into the density impostor of its cell when its molecules are under a pixel
+     * or when its points are so many that they cover their cell
+     *
+     * @param snapshot The snapshot
+     */
+    void __select_detail(const Snapshot &snapshot);
+    /**
+     * @brief Draw the molecules as point sprites: their attributes are uploaded to the buffers,
+     * then all the molecules are drawn with a single call
      *
+     * @param snapshot The snapshot to draw
      */
-    void __map_colors();
+    void __draw_sprites(const Snapshot &snapshot);
+    /**
+     * @brief Draw each molecule as a sphere, in immediate mode
+     *
+     * @param snapshot The snapshot to draw
+     */
+    void __draw_spheres(const Snapshot &snapshot);
+    /**
+     * @brief Draw the density impostors, blended over the molecules
+     *
+     */
+    void __draw_impostors();
 
     /**
-     * @brief Update the simulation
+     * @brief Start a new frame: the simulation thread is given the ticks of the frame, and the scene is redrawn
      *
-     * @param value The value to update the simulation by
+     * @param value The value of the timer
      */
     void update_simulation(int value);
     static void static_update_simulation(int value);
@@ -57,6 +159,30 @@ public:
     int m_detail_x = 50, m_detail_y = 10;
     int m_vesicle_radius = 620 / 2;
 
+    // Draw the molecules as point sprites, when the shaders are supported. Otherwise, as spheres
+    bool m_use_sprites = true;
+
+    // Cull the molecules outside of the view, and simplify the far ones
+    bool m_use_lod = true;
+
+    // The number of molecules drawn as spheres and as points, and the number of impostors, in the last frame
+    size_t m_drawn_spheres = 0, m_drawn_points = 0, m_drawn_impostors = 0;
+
+    /* The projected diameter, in pixels, from which a molecule is drawn as a sphere */
+    static constexpr float m_SPHERE_PIXELS = 4;
+
+    /* The projected diameter, in pixels, under which a molecule is aggregated into a density impostor */
+    static constexpr float m_IMPOSTOR_PIXELS = 1;
+
+    /* The part of its cell on the screen covered by the points of a bucket, from which they are aggregated too */
+    static constexpr float m_IMPOSTOR_COVERAGE = 0.25;
+
+    /* The diameter of the disc of an impostor, in sizes of its cell */
+    static constexpr float m_IMPOSTOR_SPREAD = 1.5;
+
+    /* The projected radius of the vesicle, in pixels, from which it is drawn with its full detail */
+    static constexpr float m_VESICLE_FULL_PIXELS = 400;
+
     // CONSTRUCTORS
     /**
      * @brief Construct a new View object
@@ -85,22 +211,27 @@ public:
      * @param detail_y The detail of the vesicle in the y direction
      */
     View(Simulation simulation, int vesicle_radius, int detail_x, int detail_y);
+    /**
+     * @brief Destroy the View object, after stopping the simulation thread
+     *
+     */
+    ~View();
 
     // METHODS
     void init_opengl(int argc, char **argv);
 
     /**
-     * @brief Draw the vesicle
+     * @brief Draw the vesicle, with a detail which decreases with its size on the screen
      *
      */
     void draw_vesicle();
     /**
-     * @brief Draw the legend
+     * @brief Draw the legend: the time and the state of the view, then the cached labels of the species
      *
      */
     void draw_legend();
     /**
-     * @brief Draw the molecules
+     * @brief Draw the molecules which are in the view, as point sprites or as spheres, with their level of detail
      *
      */
     void draw_molecules();
@@ -134,6 +265,15 @@ public:
      * @param y The mouse's y coordinate
      */
     void on_key_pressed(int key, int x, int y);
+    /**
+     * @brief Handle the character typed event: space pauses the simulation, + and - double and halve
+     * the ticks per frame, u runs the simulation as fast as possible, and l switches the level of detail
+     *
+     * @param key The character that was typed
+     * @param x The mouse's x coordinate
+     * @param y The mouse's y coordinate
+     */
+    void on_char_pressed(unsigned char key, int x, int y);
 
     // STATIC METHODS
     /**
@@ -160,6 +300,14 @@ public:
      * @param y The mouse's y coordinate
      */
     static void static_on_key_pressed(int key, int x, int y);
+    /**
+     * @brief Handle the character typed event
+     *
+     * @param key The character that was typed
+     * @param x The mouse's x coordinate
+     * @param y The mouse's y coordinate
+     */
+    static void static_on_char_pressed(unsigned char key, int x, int y);
     /**
      * @brief Draw the scene
      *
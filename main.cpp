@@ -4,8 +4,17 @@
 int main(int argc, char **argv)
 {
     Simulation simulation = Simulation();
+
+    // Seed the random generators if a seed is given
+    if (argc > 3)
+        simulation.m_seed = strtoull(argv[3], nullptr, 10);
+
     simulation.init(argv[1]);
 
+    // Use the parallel mode if a number of threads is given
+    if (argc > 2)
+        simulation.set_threads(atoi(argv[2]));
+
     View view = View(simulation);
     view.init_opengl(argc, argv);
     view.display();
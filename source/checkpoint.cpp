@@ -0,0 +1,135 @@
+#include "../include/checkpoint.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+
+// CONSTRUCTORS
+Checkpoint::Checkpoint(const std::string &path) : m_path(path)
+{
+    m_writer = std::thread(&Checkpoint::__write, this);
+}
+
+Checkpoint::~Checkpoint()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception &)
+    {
+    }
+}
+
+// ========================
+// METHODS
+void Checkpoint::save(const Simulation &simulation)
+{
+    simulation.save_state(m_buffer);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_error.empty())
+            throw std::runtime_error(m_error);
+
+        // Give the state to the writer, and take back the buffer of the state it has not taken yet, if any
+        m_pending.swap(m_buffer);
+        m_ready = true;
+    }
+
+    m_wake.notify_one();
+}
+
+void Checkpoint::close()
+{
+    if (m_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_one();
+        m_writer.join();
+    }
+
+    if (!m_error.empty())
+        throw std::runtime_error(m_error);
+}
+
+void Checkpoint::restore(const std::string &path, Simulation &simulation)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+
+    if (fp == NULL)
+        throw std::runtime_error("The file " + path + " could not be opened");
+
+    std::vector<char> state;
+    char chunk[1 << 16];
+    size_t read;
+
+    while ((read = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+        state.insert(state.end(), chunk, chunk + read);
+
+    fclose(fp);
+
+    simulation.load_state(state.data(), state.size());
+}
+
+// ========================
+// PRIVATE METHODS
+void Checkpoint::__write()
+{
+    std::vector<char> state;
+
+    for (;;)
+    {
+        bool stop = false, taken = false;
+
+        // Take the pending state, and give back its buffer to the simulation
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]
+                        { return m_stop || m_ready; });
+
+            if (m_ready)
+            {
+                state.swap(m_pending);
+                m_ready = false;
+                taken = true;
+            }
+
+            stop = m_stop;
+        }
+
+        if (taken)
+        {
+            const std::string error = __write_state(state);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!error.empty())
+                m_error = error;
+        }
+
+        if (stop)
+            return;
+    }
+}
+
+std::string Checkpoint::__write_state(const std::vector<char> &state)
+{
+    const std::string temporary = m_path + ".tmp";
+    FILE *fp = fopen(temporary.c_str(), "wb");
+
+    if (fp == NULL)
+        return "The file " + temporary + " could not be opened";
+
+    bool written = fwrite(state.data(), 1, state.size(), fp) == state.size();
+    written &= fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    written &= fclose(fp) == 0;
+
+    if (!written || rename(temporary.c_str(), m_path.c_str()) != 0)
+        return "The checkpoint " + m_path + " could not be written";
+
+    return "";
+}
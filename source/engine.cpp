@@ -0,0 +1,78 @@
+#include "../include/engine.hpp"
+#include <stdexcept>
+
+// ========================
+// INITIALIZATION METHODS
+void Engine::init(char *data_path)
+{
+    auto model = std::make_shared<Model>();
+    model->read_file(data_path);
+
+    init(model);
+}
+
+void Engine::init_model(std::shared_ptr<const Model> model)
+{
+    m_model = model;
+    m_reactions = model->m_reactions;
+
+    for (auto &&o : m_overrides)
+    {
+        if (o.parameter != KCAT && o.parameter != MM)
+            continue;
+
+        if (o.target < 0 || o.target >= int(m_reactions.size()))
+            throw std::runtime_error("The reaction " + std::to_string(o.target) + " does not exist");
+
+        if (o.parameter == KCAT)
+            m_reactions[o.target].kcat = o.value;
+        else
+            m_reactions[o.target].mM = o.value;
+    }
+}
+
+void Engine::init_count_molecules()
+{
+    // The species table of the model, with the overrides of the diameters and the speeds.
+    // It only holds numbers, the names stay in the model
+    m_species = m_model->m_species;
+
+    // The ids are dense, so the index of each species is found in a table of the size of the names
+    std::vector<int> species_index(m_model->m_names.size(), -1);
+
+    for (size_t s = 0; s < m_species.size(); s++)
+    {
+        Species &species = m_species[s];
+
+        // The overrides are in the units of the model files, as the instructions
+        for (auto &&o : m_overrides)
+        {
+            if (o.parameter == DIAMETER_OF && o.target == species.ident)
+                species.diameter = o.value * Parser::m_DIAMETER_SCALE;
+
+            if (o.parameter == SPEED_OF && o.target == species.ident)
+                species.speed = o.value * Parser::m_SPEED_SCALE;
+        }
+
+        species_index[species.ident] = s;
+    }
+
+    // Renumber the reactions with the compact indices of the species table
+    for (auto &&r : m_reactions)
+    {
+        r.ident = species_index[r.ident];
+        r.substrate = species_index[r.substrate];
+        r.product = species_index[r.product];
+    }
+}
+
+const std::string &Engine::species_name(size_t s) const
+{
+    return m_model->m_names[m_species[s].ident];
+}
+
+void Engine::init_probabilities()
+{
+    for (auto &&r : m_reactions)
+        Model::compute_probabilities(r);
+}
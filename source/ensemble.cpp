@@ -0,0 +1,85 @@
+#include "../include/ensemble.hpp"
+#include <cmath>
+
+// CONSTRUCTORS
+Ensemble::Ensemble(std::shared_ptr<const Model> model, std::function<std::unique_ptr<Engine>()> make_engine,
+                   unsigned long ticks, unsigned int interval)
+    : m_model(model), m_make_engine(make_engine), m_ticks(ticks), m_interval(interval ? interval : 1)
+{
+}
+
+// ========================
+// PRIVATE METHODS
+void Ensemble::__add(size_t record, const std::vector<unsigned int> &counts)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (size_t s = 0; s < counts.size(); s++)
+    {
+        m_stats[record * counts.size() + s].add(counts[s]);
+
+        for (auto &&quantile : m_quantiles[record * counts.size() + s])
+            quantile.add(counts[s]);
+    }
+}
+
+// ========================
+// METHODS
+void Ensemble::run(unsigned int replicates, uint64_t seed, ThreadPool &pool)
+{
+    const size_t n_records = m_ticks / m_interval + 1;
+
+    pool.parallel_for(replicates, [&](size_t r)
+                      {
+        std::unique_ptr<Engine> engine = m_make_engine();
+        engine->m_seed = mix_seed(seed + r);
+        engine->init(m_model);
+
+        // The first replicate to start sizes the statistics
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_stats.empty())
+            {
+                for (size_t s = 0; s < engine->m_species.size(); s++)
+                    m_names.push_back(engine->species_name(s));
+
+                std::vector<P2Quantile> quantiles;
+                for (auto &&p : m_QUANTILES)
+                    quantiles.push_back(P2Quantile(p));
+
+                m_stats.resize(n_records * m_names.size());
+                m_quantiles.assign(n_records * m_names.size(), quantiles);
+            }
+        }
+
+        __add(0, engine->m_counts);
+
+        while (engine->m_tick < m_ticks)
+        {
+            engine->step();
+
+            if (engine->m_tick % m_interval == 0)
+                __add(engine->m_tick / m_interval, engine->m_counts);
+        } });
+}
+
+void Ensemble::write(FILE *fp) const
+{
+    fprintf(fp, "tick,species,mean,variance");
+    for (auto &&p : m_QUANTILES)
+        fprintf(fp, ",q%02ld", std::lround(p * 100));
+    fprintf(fp, "\n");
+
+    const size_t n_species = m_names.size();
+
+    for (size_t i = 0; i < m_stats.size(); i++)
+    {
+        const size_t record = i / n_species, s = i % n_species;
+
+        fprintf(fp, "%lu,\"%s\",%g,%g", record * m_interval, m_names[s].c_str(), m_stats[i].m_mean, m_stats[i].variance());
+        for (auto &&quantile : m_quantiles[i])
+            fprintf(fp, ",%g", quantile.value());
+        fprintf(fp, "\n");
+    }
+}
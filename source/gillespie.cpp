@@ -0,0 +1,281 @@
+#include "../include/gillespie.hpp"
+#include <algorithm>
+#include <cmath>
+
+// PROTECTED METHODS
+double Gillespie::__rate(int channel) const
+{
+    const react &r = m_reactions[channel / m_CHANNELS];
+
+    switch (channel % m_CHANNELS)
+    {
+    // E + s -> Es, for each pair of free molecules
+    case 0:
+    {
+        const double enzymes = m_counts[r.ident] - m_bound_enzymes[r.ident];
+        const double substrates = m_counts[r.substrate] - m_bound_enzymes[r.substrate];
+
+        if (r.ident == r.substrate)
+            return m_constants[channel] * enzymes * (enzymes - 1) / 2;
+
+        return m_constants[channel] * enzymes * substrates;
+    }
+
+    // Es -> E + p, and Es -> E + s, for each bound enzyme
+    default:
+        return m_constants[channel] * m_bound[channel / m_CHANNELS];
+    }
+}
+
+void Gillespie::__fire(int channel, unsigned int count)
+{
+    const int reaction = channel / m_CHANNELS;
+    const react &r = m_reactions[reaction];
+
+    switch (channel % m_CHANNELS)
+    {
+    // E + s -> Es: the substrate is fused into the enzyme
+    case 0:
+        m_counts[r.substrate] -= count;
+        m_bound_enzymes[r.ident] += count;
+        m_bound[reaction] += count;
+        return;
+
+    // Es -> E + p
+    case 1:
+        m_counts[r.product] += count;
+        break;
+
+    // Es -> E + s
+    case 2:
+        m_counts[r.substrate] += count;
+        break;
+    }
+
+    m_bound_enzymes[r.ident] -= count;
+    m_bound[reaction] -= count;
+}
+
+double Gillespie::__draw_delay(double rate)
+{
+    if (rate <= 0)
+        return std::numeric_limits<double>::infinity();
+
+    return -std::log(1 - m_random.uniform()) / rate;
+}
+
+void Gillespie::__sift_up(int position)
+{
+    const int channel = m_heap[position];
+
+    while (position > 0)
+    {
+        const int parent = (position - 1) / 2;
+
+        if (m_times[m_heap[parent]] <= m_times[channel])
+            break;
+
+        m_heap[position] = m_heap[parent];
+        m_heap_position[m_heap[position]] = position;
+        position = parent;
+    }
+
+    m_heap[position] = channel;
+    m_heap_position[channel] = position;
+}
+
+void Gillespie::__sift_down(int position)
+{
+    const int channel = m_heap[position];
+    const int n = m_heap.size();
+
+    for (;;)
+    {
+        int child = 2 * position + 1;
+
+        if (child >= n)
+            break;
+
+        if (child + 1 < n && m_times[m_heap[child + 1]] < m_times[m_heap[child]])
+            child++;
+
+        if (m_times[channel] <= m_times[m_heap[child]])
+            break;
+
+        m_heap[position] = m_heap[child];
+        m_heap_position[m_heap[position]] = position;
+        position = child;
+    }
+
+    m_heap[position] = channel;
+    m_heap_position[channel] = position;
+}
+
+void Gillespie::__update(int channel, double time)
+{
+    m_times[channel] = time;
+
+    __sift_up(m_heap_position[channel]);
+    __sift_down(m_heap_position[channel]);
+}
+
+// ========================
+// INITIALIZATION METHODS
+void Gillespie::init(std::shared_ptr<const Model> model)
+{
+    // Keep the model, and copy its reactions
+    init_model(model);
+    m_random = Xoshiro256(m_seed);
+
+    // Initialize the attributes of the engine
+    init_count_molecules();
+    init_probabilities();
+    init_channels();
+    init_heap();
+}
+
+void Gillespie::init_channels()
+{
+    const size_t n_species = m_species.size();
+    const size_t n_channels = m_reactions.size() * m_CHANNELS;
+
+    m_counts.assign(n_species, 0);
+    for (size_t s = 0; s < n_species; s++)
+        m_counts[s] = m_species[s].count;
+
+    m_bound_enzymes.assign(n_species, 0);
+    m_bound.assign(m_reactions.size(), 0);
+    m_constants.assign(n_channels, 0);
+
+    // The quantities read and changed by the channels: the free molecules of the species 's' are 's',
+    // and the bound enzymes of the reaction 'r' are 'n_species + r'
+    std::vector<std::vector<int>> reads(n_channels), writes(n_channels);
+
+    const double vesicle_radius = vesicle_diameter / 2;
+
+    for (size_t i = 0; i < m_reactions.size(); i++)
+    {
+        const react &r = m_reactions[i];
+        const int bound = n_species + i;
+
+        // Only the first reaction between two species can bind them, as with the table of the particle engine
+        bool first = true;
+        for (size_t j = 0; j < i; j++)
+            if ((m_reactions[j].ident == r.ident && m_reactions[j].substrate == r.substrate) ||
+                (m_reactions[j].ident == r.substrate && m_reactions[j].substrate == r.ident))
+                first = false;
+
+        const double contact = (m_species[r.ident].diameter + m_species[r.substrate].diameter) / 2 / vesicle_radius;
+
+        m_constants[i * m_CHANNELS] = first ? r.p1 * contact * contact * contact : 0;
+        m_constants[i * m_CHANNELS + 1] = r.p2;
+        m_constants[i * m_CHANNELS + 2] = std::max(0.f, r.p3 - r.p2);
+
+        reads[i * m_CHANNELS] = {r.ident, r.substrate};
+        reads[i * m_CHANNELS + 1] = {bound};
+        reads[i * m_CHANNELS + 2] = {bound};
+
+        writes[i * m_CHANNELS] = {r.substrate, r.ident, bound};
+        writes[i * m_CHANNELS + 1] = {bound, r.ident, r.product};
+        writes[i * m_CHANNELS + 2] = {bound, r.ident, r.substrate};
+    }
+
+    // The channels which read each quantity
+    std::vector<std::vector<int>> readers(n_species + m_reactions.size());
+    for (size_t c = 0; c < n_channels; c++)
+        for (auto &&q : reads[c])
+            readers[q].push_back(c);
+
+    // A channel must be updated after the firing of a channel which changes one of the quantities it reads
+    m_dependents_start.assign(1, 0);
+    m_dependents.clear();
+
+    for (size_t c = 0; c < n_channels; c++)
+    {
+        std::vector<int> dependents;
+        for (auto &&q : writes[c])
+            dependents.insert(dependents.end(), readers[q].begin(), readers[q].end());
+
+        std::sort(dependents.begin(), dependents.end());
+        dependents.erase(std::unique(dependents.begin(), dependents.end()), dependents.end());
+
+        m_dependents.insert(m_dependents.end(), dependents.begin(), dependents.end());
+        m_dependents_start.push_back(m_dependents.size());
+    }
+}
+
+void Gillespie::init_heap()
+{
+    const size_t n_channels = m_constants.size();
+
+    m_rates.resize(n_channels);
+    m_times.resize(n_channels);
+    m_heap.resize(n_channels);
+    m_heap_position.resize(n_channels);
+
+    for (size_t c = 0; c < n_channels; c++)
+    {
+        m_rates[c] = __rate(c);
+        m_times[c] = m_clock + __draw_delay(m_rates[c]);
+        m_heap[c] = c;
+        m_heap_position[c] = c;
+    }
+
+    for (int p = int(n_channels) / 2 - 1; p >= 0; p--)
+        __sift_down(p);
+}
+
+// ========================
+// STEPPING METHODS
+unsigned int Gillespie::__run(double end, unsigned int reactions)
+{
+    unsigned int fired = 0;
+
+    while (fired < reactions && !m_heap.empty() && m_times[m_heap[0]] < end)
+    {
+        const int channel = m_heap[0];
+
+        m_clock = m_times[channel];
+        __fire(channel);
+        fired++;
+
+        // Update the channels whose rate has changed. The time left to the others is rescaled,
+        // which keeps the simulation exact without drawing a new number
+        for (int k = m_dependents_start[channel]; k < m_dependents_start[channel + 1]; k++)
+        {
+            const int c = m_dependents[k];
+            const double rate = __rate(c);
+
+            double time;
+            if (c != channel && m_rates[c] > 0 && rate > 0)
+                time = m_clock + m_rates[c] / rate * (m_times[c] - m_clock);
+            else
+                time = m_clock + __draw_delay(rate);
+
+            m_rates[c] = rate;
+            __update(c, time);
+        }
+    }
+
+    m_time += fired;
+    return fired;
+}
+
+void Gillespie::step()
+{
+    const double end = m_tick + 1;
+
+    __run(end, std::numeric_limits<unsigned int>::max());
+
+    m_clock = end;
+    m_tick += 1;
+}
+
+bool Gillespie::is_idle() const
+{
+    for (size_t c = 0; c < m_constants.size(); c++)
+        if (__rate(c) > 0)
+            return false;
+
+    return true;
+}
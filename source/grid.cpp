@@ -0,0 +1,60 @@
+#include "../include/grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+// METHODS
+void Grid::init(float extent, float min_cell_size)
+{
+    // Use the smallest cells allowed, without exceeding the maximum number of cells
+    m_cells = std::max(1, std::min(int(m_MAX_CELLS), int(std::floor(extent / min_cell_size))));
+    m_cell_size = extent / m_cells;
+    m_origin = -extent / 2;
+
+    m_cell_start.assign(m_cells * m_cells * m_cells + 1, 0);
+}
+
+void Grid::build(const MoleculeStore &molecules)
+{
+    std::fill(m_cell_start.begin(), m_cell_start.end(), 0);
+    m_indices.resize(molecules.size());
+    m_x.resize(molecules.size());
+    m_y.resize(molecules.size());
+    m_z.resize(molecules.size());
+    m_radius.resize(molecules.size());
+
+    // Count the molecules of each cell
+    std::vector<int> cells(molecules.size());
+    for (size_t i = 0; i < molecules.size(); i++)
+    {
+        cells[i] = cell(axis(molecules.m_x[i]), axis(molecules.m_y[i]), axis(molecules.m_z[i]));
+        m_cell_start[cells[i] + 1]++;
+    }
+
+    // Compute the start of each cell
+    for (size_t c = 1; c < m_cell_start.size(); c++)
+        m_cell_start[c] += m_cell_start[c - 1];
+
+    // Fill the cells, keeping the indices sorted inside each cell
+    std::vector<int> cursor(m_cell_start.begin(), m_cell_start.end() - 1);
+    for (size_t i = 0; i < molecules.size(); i++)
+    {
+        const int k = cursor[cells[i]]++;
+
+        m_indices[k] = i;
+        m_x[k] = molecules.m_x[i];
+        m_y[k] = molecules.m_y[i];
+        m_z[k] = molecules.m_z[i];
+        m_radius[k] = molecules.m_diameter[i] / 2;
+    }
+}
+
+int Grid::axis(float v) const
+{
+    int c = int(std::floor((v - m_origin) / m_cell_size));
+    return std::max(0, std::min(m_cells - 1, c));
+}
+
+int Grid::cell(int cx, int cy, int cz) const
+{
+    return (cx * m_cells + cy) * m_cells + cz;
+}
@@ -0,0 +1,97 @@
+#include "../include/interner.hpp"
+#include <cstring>
+
+// PRIVATE METHODS
+uint32_t Interner::__hash(std::string_view s)
+{
+    uint32_t h = 2166136261u;
+
+    for (auto &&c : s)
+        h = (h ^ uint8_t(c)) * 16777619u;
+
+    return h;
+}
+
+size_t Interner::__slot(std::string_view s, uint32_t h) const
+{
+    const size_t mask = m_slots.size() - 1;
+
+    // Probe the slots one after the other, until the string or an empty slot.
+    // The table is at most half full, so there is always an empty slot
+    for (size_t slot = h & mask;; slot = (slot + 1) & mask)
+    {
+        const int id = m_slots[slot];
+
+        if (id == -1 || (m_hashes[id] == h && m_symbols[id] == s))
+            return slot;
+    }
+}
+
+void Interner::__grow()
+{
+    m_slots.assign(m_slots.size() * 2, -1);
+
+    const size_t mask = m_slots.size() - 1;
+
+    // The strings are all different, so each one goes to the first empty slot
+    for (size_t id = 0; id < m_symbols.size(); id++)
+    {
+        size_t slot = m_hashes[id] & mask;
+        while (m_slots[slot] != -1)
+            slot = (slot + 1) & mask;
+
+        m_slots[slot] = id;
+    }
+}
+
+std::string_view Interner::__copy(std::string_view s)
+{
+    // A string longer than a block has its own block, and the next strings go to a new block
+    if (s.size() > m_ARENA_BLOCK)
+    {
+        m_arena.push_back(std::make_unique<char[]>(s.size()));
+        m_arena_used = m_ARENA_BLOCK;
+    }
+
+    // A new block when the last one is full
+    else if (m_arena_used + s.size() > m_ARENA_BLOCK)
+    {
+        m_arena.push_back(std::make_unique<char[]>(m_ARENA_BLOCK));
+        m_arena_used = 0;
+    }
+
+    char *copy = m_arena.back().get() + (s.size() > m_ARENA_BLOCK ? 0 : m_arena_used);
+    memcpy(copy, s.data(), s.size());
+
+    if (s.size() <= m_ARENA_BLOCK)
+        m_arena_used += s.size();
+
+    return std::string_view(copy, s.size());
+}
+
+// METHODS
+int Interner::find(std::string_view s) const
+{
+    return m_slots[__slot(s, __hash(s))];
+}
+
+int Interner::intern(std::string_view s, bool copy)
+{
+    const uint32_t h = __hash(s);
+    const size_t slot = __slot(s, h);
+
+    if (m_slots[slot] != -1)
+        return m_slots[slot];
+
+    // Insert the string with the next id
+    const int id = m_symbols.size();
+
+    m_symbols.push_back(copy ? __copy(s) : s);
+    m_hashes.push_back(h);
+    m_slots[slot] = id;
+
+    if (2 * m_symbols.size() > m_slots.size())
+        __grow();
+
+    return id;
+}
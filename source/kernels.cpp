@@ -0,0 +1,355 @@
+#include "../include/kernels.hpp"
+#include <algorithm>
+
+// GCC 12 warns that the AVX-512 intrinsics, which start from an undefined register, use it uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+// The floating point operations must not be fused into FMA, even with -march=native,
+// so every kernel gives the same moves as the scalar one
+#pragma GCC optimize("fp-contract=off")
+
+// The constants of the kernels
+static const float HALF_PI = 1.57079632679489662f;
+static const float SQRT1_2 = 0.70710678118654752f;
+static const float INV_2_24 = 0x1.0p-24f;
+
+// Taylor coefficients of sin and cos on [-pi/4, pi/4]
+static const float S3 = -1.0f / 6, S5 = 1.0f / 120, S7 = -1.0f / 5040;
+static const float C2 = -1.0f / 2, C4 = 1.0f / 24, C6 = -1.0f / 720, C8 = 1.0f / 40320;
+
+// Philox4x32-10 constants
+static const uint32_t PHILOX_M0 = 0xD2511F53, PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9, PHILOX_W1 = 0xBB67AE85;
+
+void Moves::resize(size_t n)
+{
+    m_x.resize(n);
+    m_y.resize(n);
+    m_z.resize(n);
+    m_proba.resize(n);
+    m_inside.resize(n);
+}
+
+// ========================
+// SCALAR KERNEL
+// The angle is made of a quadrant (the 2 high bits of the first number)
+// and of an offset a in [-pi/4, pi/4) from the middle of the quadrant (the next 24 bits).
+static void __propose_scalar(const MoleculeStore &molecules, const Philox &philox, uint64_t tick, float radius,
+                             size_t first, size_t count, Moves &moves)
+{
+    for (size_t i = first; i < first + count; i++)
+    {
+        uint32_t draw[4];
+        philox.draw(tick, i, draw);
+
+        const uint32_t q = draw[0] >> 30;
+        const float f = float((draw[0] >> 6) & 0xFFFFFF) * INV_2_24;
+        const float a = (f - 0.5f) * HALF_PI;
+        const float a2 = a * a;
+
+        const float s = a * (1.0f + a2 * (S3 + a2 * (S5 + a2 * S7)));
+        const float c = 1.0f + a2 * (C2 + a2 * (C4 + a2 * (C6 + a2 * C8)));
+
+        // cos and sin of pi/4 + a
+        const float cx = (c - s) * SQRT1_2;
+        const float sy = (c + s) * SQRT1_2;
+
+        // Rotate by the quadrant
+        const float u = q & 1 ? sy : cx;
+        const float v = q & 1 ? cx : sy;
+        const float dx = (q ^ (q >> 1)) & 1 ? -u : u;
+        const float dy = q >> 1 ? -v : v;
+
+        const float speed = molecules.m_speed[i];
+        const float x = molecules.m_x[i] + speed * dx;
+        const float y = molecules.m_y[i] + speed * dy;
+        const float z = molecules.m_z[i] + (draw[1] >> 31 ? speed : -speed);
+
+        const float limit = radius - molecules.m_diameter[i] * 0.5f;
+
+        moves.m_x[i] = x;
+        moves.m_y[i] = y;
+        moves.m_z[i] = z;
+        moves.m_proba[i] = float(draw[2] >> 8) * INV_2_24;
+        moves.m_inside[i] = x * x + y * y + z * z <= limit * limit;
+    }
+}
+
+// ========================
+// AVX2 KERNEL
+__attribute__((target("avx2"))) static inline void __mulhilo_avx2(__m256i a, __m256i m, __m256i &hi, __m256i &lo)
+{
+    // Multiply the even and the odd lanes, then interleave the 32 bits halves
+    const __m256i even = _mm256_mul_epu32(a, m);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+__attribute__((target("avx2"))) static void __propose_avx2(const MoleculeStore &molecules, const Philox &philox, uint64_t tick, float radius,
+                                                          size_t first, size_t count, Moves &moves)
+{
+    const size_t end = first + count;
+    size_t i = first;
+
+    for (; i + 8 <= end; i += 8)
+    {
+        // Philox4x32-10 on 8 counters
+        alignas(32) uint32_t lo[8], hi[8];
+        for (int l = 0; l < 8; l++)
+        {
+            lo[l] = uint32_t(i + l);
+            hi[l] = uint32_t(uint64_t(i + l) >> 32);
+        }
+
+        __m256i c0 = _mm256_load_si256((const __m256i *)lo);
+        __m256i c1 = _mm256_load_si256((const __m256i *)hi);
+        __m256i c2 = _mm256_set1_epi32(uint32_t(tick));
+        __m256i c3 = _mm256_set1_epi32(uint32_t(tick >> 32));
+        uint32_t k0 = philox.m_key[0], k1 = philox.m_key[1];
+
+        const __m256i m0 = _mm256_set1_epi32(PHILOX_M0);
+        const __m256i m1 = _mm256_set1_epi32(PHILOX_M1);
+
+        for (int round = 0; round < 10; round++)
+        {
+            __m256i hi0, lo0, hi1, lo1;
+            __mulhilo_avx2(c0, m0, hi0, lo0);
+            __mulhilo_avx2(c2, m1, hi1, lo1);
+
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(k0));
+            c1 = lo1;
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(k1));
+            c3 = lo0;
+
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        // Direction in the xy plane
+        const __m256i q = _mm256_srli_epi32(c0, 30);
+        const __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(c0, 6), _mm256_set1_epi32(0xFFFFFF))), _mm256_set1_ps(INV_2_24));
+        const __m256 a = _mm256_mul_ps(_mm256_sub_ps(f, _mm256_set1_ps(0.5f)), _mm256_set1_ps(HALF_PI));
+        const __m256 a2 = _mm256_mul_ps(a, a);
+
+        __m256 s = _mm256_add_ps(_mm256_set1_ps(S5), _mm256_mul_ps(a2, _mm256_set1_ps(S7)));
+        s = _mm256_add_ps(_mm256_set1_ps(S3), _mm256_mul_ps(a2, s));
+        s = _mm256_mul_ps(a, _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(a2, s)));
+
+        __m256 c = _mm256_add_ps(_mm256_set1_ps(C6), _mm256_mul_ps(a2, _mm256_set1_ps(C8)));
+        c = _mm256_add_ps(_mm256_set1_ps(C4), _mm256_mul_ps(a2, c));
+        c = _mm256_add_ps(_mm256_set1_ps(C2), _mm256_mul_ps(a2, c));
+        c = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(a2, c));
+
+        const __m256 cx = _mm256_mul_ps(_mm256_sub_ps(c, s), _mm256_set1_ps(SQRT1_2));
+        const __m256 sy = _mm256_mul_ps(_mm256_add_ps(c, s), _mm256_set1_ps(SQRT1_2));
+
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+        const __m256 neg_x = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_xor_si256(q, _mm256_srli_epi32(q, 1)), one), one));
+        const __m256 neg_y = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_srli_epi32(q, 1), one));
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+
+        const __m256 u = _mm256_blendv_ps(cx, sy, swap);
+        const __m256 v = _mm256_blendv_ps(sy, cx, swap);
+        const __m256 dx = _mm256_xor_ps(u, _mm256_and_ps(sign, neg_x));
+        const __m256 dy = _mm256_xor_ps(v, _mm256_and_ps(sign, neg_y));
+
+        // Apply the move, up along z if the high bit of the second number is set
+        const __m256 speed = _mm256_loadu_ps(&molecules.m_speed[i]);
+        const __m256 down = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_srli_epi32(c1, 31), _mm256_setzero_si256()));
+
+        const __m256 x = _mm256_add_ps(_mm256_loadu_ps(&molecules.m_x[i]), _mm256_mul_ps(speed, dx));
+        const __m256 y = _mm256_add_ps(_mm256_loadu_ps(&molecules.m_y[i]), _mm256_mul_ps(speed, dy));
+        const __m256 z = _mm256_add_ps(_mm256_loadu_ps(&molecules.m_z[i]), _mm256_xor_ps(speed, _mm256_and_ps(sign, down)));
+
+        // Mask out the moves outside the vesicle
+        const __m256 limit = _mm256_sub_ps(_mm256_set1_ps(radius), _mm256_mul_ps(_mm256_loadu_ps(&molecules.m_diameter[i]), _mm256_set1_ps(0.5f)));
+        const __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+        const int inside = _mm256_movemask_ps(_mm256_cmp_ps(d2, _mm256_mul_ps(limit, limit), _CMP_LE_OQ));
+
+        _mm256_storeu_ps(&moves.m_x[i], x);
+        _mm256_storeu_ps(&moves.m_y[i], y);
+        _mm256_storeu_ps(&moves.m_z[i], z);
+        _mm256_storeu_ps(&moves.m_proba[i], _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(c2, 8)), _mm256_set1_ps(INV_2_24)));
+
+        for (int l = 0; l < 8; l++)
+            moves.m_inside[i + l] = (inside >> l) & 1;
+    }
+
+    // The last molecules of the batch
+    __propose_scalar(molecules, philox, tick, radius, i, end - i, moves);
+}
+
+// ========================
+// AVX-512 KERNEL
+__attribute__((target("avx512f"))) static inline void __mulhilo_avx512(__m512i a, __m512i m, __m512i &hi, __m512i &lo)
+{
+    const __m512i even = _mm512_mul_epu32(a, m);
+    const __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+
+    lo = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+    hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+}
+
+__attribute__((target("avx512f"))) static void __propose_avx512(const MoleculeStore &molecules, const Philox &philox, uint64_t tick, float radius,
+                                                                 size_t first, size_t count, Moves &moves)
+{
+    const size_t end = first + count;
+    size_t i = first;
+
+    for (; i + 16 <= end; i += 16)
+    {
+        // Philox4x32-10 on 16 counters
+        alignas(64) uint32_t lo[16], hi[16];
+        for (int l = 0; l < 16; l++)
+        {
+            lo[l] = uint32_t(i + l);
+            hi[l] = uint32_t(uint64_t(i + l) >> 32);
+        }
+
+        __m512i c0 = _mm512_load_si512(lo);
+        __m512i c1 = _mm512_load_si512(hi);
+        __m512i c2 = _mm512_set1_epi32(uint32_t(tick));
+        __m512i c3 = _mm512_set1_epi32(uint32_t(tick >> 32));
+        uint32_t k0 = philox.m_key[0], k1 = philox.m_key[1];
+
+        const __m512i m0 = _mm512_set1_epi32(PHILOX_M0);
+        const __m512i m1 = _mm512_set1_epi32(PHILOX_M1);
+
+        for (int round = 0; round < 10; round++)
+        {
+            __m512i hi0, lo0, hi1, lo1;
+            __mulhilo_avx512(c0, m0, hi0, lo0);
+            __mulhilo_avx512(c2, m1, hi1, lo1);
+
+            c0 = _mm512_xor_si512(_mm512_xor_si512(hi1, c1), _mm512_set1_epi32(k0));
+            c1 = lo1;
+            c2 = _mm512_xor_si512(_mm512_xor_si512(hi0, c3), _mm512_set1_epi32(k1));
+            c3 = lo0;
+
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        // Direction in the xy plane
+        const __m512i q = _mm512_srli_epi32(c0, 30);
+        const __m512 f = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(c0, 6), _mm512_set1_epi32(0xFFFFFF))), _mm512_set1_ps(INV_2_24));
+        const __m512 a = _mm512_mul_ps(_mm512_sub_ps(f, _mm512_set1_ps(0.5f)), _mm512_set1_ps(HALF_PI));
+        const __m512 a2 = _mm512_mul_ps(a, a);
+
+        __m512 s = _mm512_add_ps(_mm512_set1_ps(S5), _mm512_mul_ps(a2, _mm512_set1_ps(S7)));
+        s = _mm512_add_ps(_mm512_set1_ps(S3), _mm512_mul_ps(a2, s));
+        s = _mm512_mul_ps(a, _mm512_add_ps(_mm512_set1_ps(1.0f), _mm512_mul_ps(a2, s)));
+
+        __m512 c = _mm512_add_ps(_mm512_set1_ps(C6), _mm512_mul_ps(a2, _mm512_set1_ps(C8)));
+        c = _mm512_add_ps(_mm512_set1_ps(C4), _mm512_mul_ps(a2, c));
+        c = _mm512_add_ps(_mm512_set1_ps(C2), _mm512_mul_ps(a2, c));
+        c = _mm512_add_ps(_mm512_set1_ps(1.0f), _mm512_mul_ps(a2, c));
+
+        const __m512 cx = _mm512_mul_ps(_mm512_sub_ps(c, s), _mm512_set1_ps(SQRT1_2));
+        const __m512 sy = _mm512_mul_ps(_mm512_add_ps(c, s), _mm512_set1_ps(SQRT1_2));
+
+        const __m512i one = _mm512_set1_epi32(1);
+        const __mmask16 swap = _mm512_cmpeq_epi32_mask(_mm512_and_si512(q, one), one);
+        const __mmask16 neg_x = _mm512_cmpeq_epi32_mask(_mm512_and_si512(_mm512_xor_si512(q, _mm512_srli_epi32(q, 1)), one), one);
+        const __mmask16 neg_y = _mm512_cmpeq_epi32_mask(_mm512_srli_epi32(q, 1), one);
+        const __mmask16 down = _mm512_cmpeq_epi32_mask(_mm512_srli_epi32(c1, 31), _mm512_setzero_si512());
+        const __m512i sign = _mm512_set1_epi32(0x80000000);
+
+        const __m512 u = _mm512_mask_blend_ps(swap, cx, sy);
+        const __m512 v = _mm512_mask_blend_ps(swap, sy, cx);
+        const __m512 dx = _mm512_castsi512_ps(_mm512_mask_xor_epi32(_mm512_castps_si512(u), neg_x, _mm512_castps_si512(u), sign));
+        const __m512 dy = _mm512_castsi512_ps(_mm512_mask_xor_epi32(_mm512_castps_si512(v), neg_y, _mm512_castps_si512(v), sign));
+
+        // Apply the move, up along z if the high bit of the second number is set
+        const __m512 speed = _mm512_loadu_ps(&molecules.m_speed[i]);
+        const __m512 step_z = _mm512_castsi512_ps(_mm512_mask_xor_epi32(_mm512_castps_si512(speed), down, _mm512_castps_si512(speed), sign));
+
+        const __m512 x = _mm512_add_ps(_mm512_loadu_ps(&molecules.m_x[i]), _mm512_mul_ps(speed, dx));
+        const __m512 y = _mm512_add_ps(_mm512_loadu_ps(&molecules.m_y[i]), _mm512_mul_ps(speed, dy));
+        const __m512 z = _mm512_add_ps(_mm512_loadu_ps(&molecules.m_z[i]), step_z);
+
+        // Mask out the moves outside the vesicle
+        const __m512 limit = _mm512_sub_ps(_mm512_set1_ps(radius), _mm512_mul_ps(_mm512_loadu_ps(&molecules.m_diameter[i]), _mm512_set1_ps(0.5f)));
+        const __m512 d2 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(x, x), _mm512_mul_ps(y, y)), _mm512_mul_ps(z, z));
+        const __mmask16 inside = _mm512_cmp_ps_mask(d2, _mm512_mul_ps(limit, limit), _CMP_LE_OQ);
+
+        _mm512_storeu_ps(&moves.m_x[i], x);
+        _mm512_storeu_ps(&moves.m_y[i], y);
+        _mm512_storeu_ps(&moves.m_z[i], z);
+        _mm512_storeu_ps(&moves.m_proba[i], _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(c2, 8)), _mm512_set1_ps(INV_2_24)));
+
+        for (int l = 0; l < 16; l++)
+            moves.m_inside[i + l] = (inside >> l) & 1;
+    }
+
+    // The last molecules of the batch
+    __propose_scalar(molecules, philox, tick, radius, i, end - i, moves);
+}
+
+// ========================
+// DISPATCH
+static Isa __best_isa()
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        return AVX512;
+
+    if (__builtin_cpu_supports("avx2"))
+        return AVX2;
+
+    return SCALAR;
+}
+
+static Isa g_isa = __best_isa();
+
+void propose_moves(const MoleculeStore &molecules, const Philox &philox, uint64_t tick, float radius,
+                   size_t first, size_t count, Moves &moves)
+{
+    switch (g_isa)
+    {
+    case AVX512:
+        __propose_avx512(molecules, philox, tick, radius, first, count, moves);
+        break;
+
+    case AVX2:
+        __propose_avx2(molecules, philox, tick, radius, first, count, moves);
+        break;
+
+    default:
+        __propose_scalar(molecules, philox, tick, radius, first, count, moves);
+        break;
+    }
+}
+
+Isa kernel_isa()
+{
+    return g_isa;
+}
+
+Isa set_kernel_isa(Isa isa)
+{
+    g_isa = std::min(isa, __best_isa());
+    return g_isa;
+}
+
+const char *isa_name(Isa isa)
+{
+    switch (isa)
+    {
+    case AVX512:
+        return "avx512";
+
+    case AVX2:
+        return "avx2";
+
+    default:
+        return "scalar";
+    }
+}
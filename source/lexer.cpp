@@ -1,58 +1,213 @@
 #include "../include/lexer.hpp"
 #include <exception>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // CONSTRUCTOR
 Lexer::Lexer() {}
-Lexer::~Lexer() {}
+Lexer::~Lexer()
+{
+    for (auto &&mapping : m_mappings)
+        munmap(mapping.first, mapping.second);
+}
 
-// METHODS
-int Lexer::hash(char *s)
+// PRIVATE METHODS
+UL Lexer::__lex_mapped(const char *&cursor, const char *end)
 {
-    // Initialize the hash
-    int h = 11;
+    // The same automaton as lex(), where the token is kept as a pointer into the mapping instead of a buffer
+    int state = STD;
+    const char *start = cursor;
 
-    // While the string is not empty hash the string
-    while (*s != 0)
-        h = ((h * 19) ^ int(*s++)) % m_HASH_SIZE;
+    // Loop through the file
+    for (;;)
+    {
+        // The end of the file
+        if (cursor == end)
+            return UL{END_OF_FILE, 0};
 
-    // If the hash is negative, make it positive
-    if (h < 0)
-        h = h + m_HASH_SIZE;
+        const char charac = *cursor++;
 
-    return h;
-}
+        // The end of the line
+        if (charac == '\n')
+            return UL{END, 0};
 
-int Lexer::index(char *s, bool insert)
-{
-    // Get the hash of the string
-    int h = hash(s);
+        // Automata to extract the tokens
+        switch (state)
+        {
+        case STD:
+            start = cursor - 1;
 
-    // Search for the string in the table
-    for (int n = 0; n < m_HASH_SIZE; n++)
-    {
-        // Get the string at the index 'h' of the table
-        char *t = m_table[h];
+            // Ignore the spaces and the new lines
+            if (charac == ' ' or charac == '\t')
+                continue;
+
+            // Extract ponctuation
+            if (charac == ';')
+                return UL{PONCT, Ponct::SEMICOLON};
+
+            if (charac == ':')
+                return UL{PONCT, Ponct::COLON};
+
+            if (charac == '+')
+                return UL{PONCT, Ponct::PLUS};
+
+            if (charac == '|')
+                return UL{PONCT, Ponct::VBAR};
+
+            if (charac == ',')
+                return UL{PONCT, Ponct::COMMA};
+
+            if (charac == '(')
+                return UL{PONCT, Ponct::PARENTHESIS_OPEN};
+
+            if (charac == ')')
+                return UL{PONCT, Ponct::PARENTHESIS_CLOSE};
+
+            if (charac == '=')
+                return UL{PONCT, Ponct::EQUAL};
+
+            // Extract the - and the ->
+            if (charac == '-')
+            {
+                state = PROBABLY_ARROW;
+                continue;
+            }
 
-        // If 't' is zero, the string is not in the table
-        if (t == 0)
+            // Extract the identifiers starting with a '"', without the '"'
+            if (charac == '"')
+            {
+                state = IDENT;
+                start = cursor;
+                continue;
+            }
+
+            // Extract the identifiers starting with a letter
+            if ((charac >= 'a' and charac <= 'z') or (charac >= 'A' and charac <= 'Z') or charac == '_')
+            {
+                state = IDENT_P;
+                continue;
+            }
+
+            // Extract the numbers
+            if (charac == '.' or (charac >= '0' and charac <= '9'))
+            {
+                state = NUM;
+                continue;
+            }
+
+            // Extract the comments
+            if (charac == '/')
+            {
+                state = PROBABLY_COMMENT;
+                continue;
+            }
+
+            // Return error if the character is not recognized
+            return UL{ERROR, 0};
+
+        case NUM:
+            // Extract the numbers
+            if (charac == '.' or charac == 'e' or (charac >= '0' and charac <= '9'))
+                continue;
+
+            // If the number is finished, return the token. The mapping is not terminated, so the number is copied
+            {
+                cursor--;
+
+                const std::string number(start, cursor - start);
+                return UL{NUM, std::atof(number.c_str())};
+            }
+
+        case IDENT:
+            // Extract the identifiers starting with a '"'
+            if (charac == '"')
+                return UL{IDENT, index(std::string_view(start, cursor - 1 - start), true)};
+
+            continue;
+
+        case IDENT_P:
         {
-            if (!insert)
-                return -1;
+            // Extract the identifiers starting with a letter
+            const std::string_view word(start, cursor - 1 - start);
+
+            // Search for the unit uM
+            if (word.back() == 'u' and charac == 'M')
+                return UL{UNIT, Unit::uM};
 
-            // Insert the string in the table, and return the index
-            m_table[h] = strdup(s);
-            return h;
+            // Search for the unit mM
+            if (word.back() == 'm' and charac == 'M')
+                return UL{UNIT, Unit::mM};
+
+            // Search for the keywords init
+            if (word == "ini" and charac == 't')
+                return UL{KEYWORD, Keyword::INIT};
+
+            // Search for the keywords diametre
+            if (word == "diametr" and charac == 'e')
+                return UL{KEYWORD, Keyword::DIAMETER};
+
+            // Search for the keywords vitesse
+            if (word == "vitess" and charac == 'e')
+                return UL{KEYWORD, Keyword::SPEED};
+
+            // Extract the identifiers starting with a letter
+            if ((charac >= 'a' and charac <= 'z') or (charac >= 'A' and charac <= 'Z') or (charac >= '0' and charac <= '9'))
+                continue;
+
+            // If the identifier is finished, return the token
+            cursor--;
+            return UL{IDENT, index(word, true)};
         }
 
-        // If the string is in the table, return the index
-        if (strcmp(s, t) == 0)
-            return h;
+        case PROBABLY_ARROW:
+            // Extract the ->
+            if (charac == '>')
+                return UL{PONCT, Ponct::ARROW};
+
+            // Extract the -
+            return UL{PONCT, Ponct::MINUS};
 
-        // Otherwise, go to the next index to search for the string
-        h = (h + 41) % m_HASH_SIZE;
+        case PROBABLY_COMMENT:
+            // Extract the comments starting with //
+            if (charac != '/')
+                return UL{ERROR, 0};
+
+            // Ignore the comments, up to the end of the line
+            {
+                const char *line_end = static_cast<const char *>(memchr(cursor, '\n', end - cursor));
+
+                if (line_end == nullptr)
+                {
+                    cursor = end;
+                    return UL{END_OF_FILE, 0};
+                }
+
+                cursor = line_end + 1;
+                return UL{END, 0};
+            }
+
+        default:
+            break;
+        }
     }
+}
 
-    return -2;
+// METHODS
+int Lexer::index(std::string_view s, bool insert)
+{
+    if (!insert)
+        return m_table.find(s);
+
+    // A string which is not in a mapped file is copied, since it may not outlive the call
+    for (auto &&mapping : m_mappings)
+        if (s.data() >= static_cast<const char *>(mapping.first) &&
+            s.data() + s.size() <= static_cast<const char *>(mapping.first) + mapping.second)
+            return m_table.intern(s, false);
+
+    return m_table.intern(s, true);
 }
 
 UL Lexer::lex(FILE *fp)
@@ -304,6 +459,59 @@ std::vector<UL> Lexer::lex_all(FILE *fp)
     return tokens;
 }
 
+std::vector<UL> Lexer::lex_mapped(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd == -1)
+        throw std::runtime_error("The file could not be opened");
+
+    struct stat info;
+    if (fstat(fd, &info) == -1)
+    {
+        close(fd);
+        throw std::runtime_error("The file could not be opened");
+    }
+
+    // An empty file can not be mapped, and has no token
+    const size_t size = info.st_size;
+    if (size == 0)
+    {
+        close(fd);
+        return std::vector<UL>{UL{END_OF_FILE, 0}};
+    }
+
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("The file could not be mapped");
+
+    // The file is read once, from the start to the end
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    m_mappings.push_back({mapping, size});
+
+    const char *cursor = static_cast<const char *>(mapping);
+    const char *end = cursor + size;
+
+    // Define the vector of tokens, with a guess of a token every 4 characters
+    std::vector<UL> tokens;
+    tokens.reserve(size / 4 + 1);
+
+    // Loop through the file
+    for (;;)
+    {
+        // Add the token to the vector
+        UL token = __lex_mapped(cursor, end);
+        tokens.push_back(token);
+
+        if (token.type == END_OF_FILE)
+            break;
+    }
+
+    return tokens;
+}
+
 void Lexer::print_ul(UL ul)
 {
     switch (ul.type)
@@ -0,0 +1,323 @@
+#include "../include/model.hpp"
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The layout of a compiled model: the header, the reactions, the species, the instructions, the offsets
+// of the names, then the names. All the fields are 4 bytes, in the byte order of the machine
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t n_reactions, n_species, n_instructions, n_names;
+    uint32_t names_size;
+};
+
+struct BinaryReaction
+{
+    int32_t ident, substrate, product;
+    float mM, kcat, p1, p2, p3;
+};
+
+struct BinarySpecies
+{
+    int32_t ident;
+    float diameter, speed;
+    int32_t count;
+};
+
+struct BinaryInstruction
+{
+    int32_t type, ident;
+    float value;
+};
+
+static_assert(std::is_trivially_copyable<BinaryHeader>::value && sizeof(BinaryHeader) == 32, "The header must have no padding");
+static_assert(sizeof(BinaryReaction) == 32 && sizeof(BinarySpecies) == 16 && sizeof(BinaryInstruction) == 12, "The records must have no padding");
+
+// PRIVATE METHODS
+std::map<int, std::tuple<int, int, int>> Model::__map_instructions() const
+{
+    // Ident: {Count, Diameter, Speed}
+    std::map<int, std::tuple<int, int, int>> map;
+    const std::vector<instr> &instructions = m_instructions;
+
+    for (int i = 0; i < instructions.size(); i++)
+    {
+        switch (instructions[i].type)
+        {
+        case Keyword::INIT:
+            if (map.find(instructions[i].ident) != map.end())
+                std::get<0>(map[instructions[i].ident]) += instructions[i].value;
+            else
+                map[instructions[i].ident] = {instructions[i].value, 0, 0};
+
+            continue;
+
+        case Keyword::DIAMETER:
+            if (map.find(instructions[i].ident) != map.end())
+                std::get<1>(map[instructions[i].ident]) = instructions[i].value;
+            else
+                map[instructions[i].ident] = {0, instructions[i].value, 0};
+
+            continue;
+
+        case Keyword::SPEED:
+            if (map.find(instructions[i].ident) != map.end())
+                std::get<2>(map[instructions[i].ident]) = instructions[i].value;
+            else
+                map[instructions[i].ident] = {0, 0, instructions[i].value};
+
+            continue;
+        }
+    }
+
+    return map;
+}
+
+void Model::__read_binary(const char *data, size_t size)
+{
+    BinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if (header.version != m_VERSION)
+        throw std::runtime_error("The compiled model has the version " + std::to_string(header.version) +
+                                 ", and this program reads the version " + std::to_string(m_VERSION));
+
+    // The sections of the file
+    const BinaryReaction *reactions = reinterpret_cast<const BinaryReaction *>(data + sizeof(header));
+    const BinarySpecies *species = reinterpret_cast<const BinarySpecies *>(reactions + header.n_reactions);
+    const BinaryInstruction *instructions = reinterpret_cast<const BinaryInstruction *>(species + header.n_species);
+    const uint32_t *offsets = reinterpret_cast<const uint32_t *>(instructions + header.n_instructions);
+    const char *names = reinterpret_cast<const char *>(offsets + header.n_names + 1);
+
+    const size_t expected = sizeof(header) + size_t(header.n_reactions) * sizeof(BinaryReaction) +
+                            size_t(header.n_species) * sizeof(BinarySpecies) +
+                            size_t(header.n_instructions) * sizeof(BinaryInstruction) +
+                            (size_t(header.n_names) + 1) * sizeof(uint32_t) + header.names_size;
+
+    if (size != expected)
+        throw std::runtime_error("The compiled model is truncated or corrupted");
+
+    m_names.resize(header.n_names);
+    for (uint32_t i = 0; i < header.n_names; i++)
+    {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > header.names_size)
+            throw std::runtime_error("The compiled model is truncated or corrupted");
+
+        m_names[i].assign(names + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    // The ids of the molecules must be in the table of the names
+    auto check = [&](int32_t ident)
+    {
+        if (ident < 0 || uint32_t(ident) >= header.n_names)
+            throw std::runtime_error("The compiled model is truncated or corrupted");
+    };
+
+    m_reactions.resize(header.n_reactions);
+    for (uint32_t i = 0; i < header.n_reactions; i++)
+    {
+        const BinaryReaction &b = reactions[i];
+        check(b.ident), check(b.substrate), check(b.product);
+
+        m_reactions[i] = react{b.ident, b.substrate, b.product, b.mM, b.kcat, b.p1, b.p2, b.p3};
+    }
+
+    m_species.resize(header.n_species);
+    for (uint32_t i = 0; i < header.n_species; i++)
+    {
+        const BinarySpecies &b = species[i];
+        check(b.ident);
+
+        m_species[i] = Species{b.ident, b.diameter, b.speed, b.count};
+    }
+
+    m_instructions.resize(header.n_instructions);
+    for (uint32_t i = 0; i < header.n_instructions; i++)
+    {
+        const BinaryInstruction &b = instructions[i];
+        check(b.ident);
+
+        m_instructions[i] = instr{Keyword(b.type), b.ident, b.value};
+    }
+
+    __build_reaction_table();
+}
+
+void Model::__build_reaction_table()
+{
+    // The index of each id in the species table
+    std::vector<int> species_index(m_names.size(), -1);
+    for (size_t s = 0; s < m_species.size(); s++)
+        species_index[m_species[s].ident] = s;
+
+    const size_t n_species = m_species.size();
+    m_reaction_table.assign(n_species * n_species, -1);
+
+    // Fill from the last reaction, so the first reaction between two species is kept
+    for (size_t i = m_reactions.size(); i-- > 0;)
+    {
+        const int enzyme = species_index[m_reactions[i].ident];
+        const int substrate = species_index[m_reactions[i].substrate];
+
+        if (enzyme == -1 || substrate == -1 || species_index[m_reactions[i].product] == -1)
+            throw std::runtime_error("The reaction " + std::to_string(i) + " uses a molecule which is not in the species table");
+
+        m_reaction_table[enzyme * n_species + substrate] = i;
+        m_reaction_table[substrate * n_species + enzyme] = i;
+    }
+}
+
+// METHODS
+void Model::read_file(const char *data_path)
+{
+    int fd = open(data_path, O_RDONLY);
+
+    if (fd == -1)
+        throw std::runtime_error("The file could not be opened");
+
+    // A compiled model starts with the magic number
+    struct stat info;
+    char magic[sizeof(m_MAGIC)] = {0};
+
+    if (fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(BinaryHeader) &&
+        pread(fd, magic, sizeof(magic), 0) == sizeof(magic) && !memcmp(magic, m_MAGIC, sizeof(magic)))
+    {
+        void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("The file could not be mapped");
+
+        try
+        {
+            __read_binary(static_cast<const char *>(mapping), info.st_size);
+        }
+        catch (...)
+        {
+            munmap(mapping, info.st_size);
+            throw;
+        }
+
+        munmap(mapping, info.st_size);
+        return;
+    }
+
+    close(fd);
+
+    Lexer lexer = Lexer();
+    Parser parser = Parser();
+
+    parser.parse(lexer.lex_mapped(data_path), m_reactions, m_instructions);
+
+    // Store the names of the molecules. The ids are dense, so the name of the id 'i' is the i-th name
+    m_names.reserve(lexer.m_table.size());
+    for (auto &&name : lexer.m_table.m_symbols)
+        m_names.emplace_back(name);
+
+    resolve();
+}
+
+void Model::write_binary(const char *path) const
+{
+    BinaryHeader header;
+    memcpy(header.magic, m_MAGIC, sizeof(header.magic));
+    header.version = m_VERSION;
+    header.n_reactions = m_reactions.size();
+    header.n_species = m_species.size();
+    header.n_instructions = m_instructions.size();
+    header.n_names = m_names.size();
+
+    std::vector<BinaryReaction> reactions;
+    for (auto &&r : m_reactions)
+        reactions.push_back(BinaryReaction{r.ident, r.substrate, r.product, r.mM, r.kcat, r.p1, r.p2, r.p3});
+
+    std::vector<BinarySpecies> species;
+    for (auto &&s : m_species)
+        species.push_back(BinarySpecies{s.ident, s.diameter, s.speed, s.count});
+
+    std::vector<BinaryInstruction> instructions;
+    for (auto &&i : m_instructions)
+        instructions.push_back(BinaryInstruction{int32_t(i.type), i.ident, i.value});
+
+    std::vector<uint32_t> offsets(1, 0);
+    std::string names;
+    for (auto &&name : m_names)
+    {
+        names += name;
+        offsets.push_back(names.size());
+    }
+    header.names_size = names.size();
+
+    FILE *fp = fopen(path, "wb");
+
+    if (fp == NULL)
+        throw std::runtime_error("The file could not be opened");
+
+    bool written = fwrite(&header, sizeof(header), 1, fp) == 1;
+    written &= fwrite(reactions.data(), sizeof(BinaryReaction), reactions.size(), fp) == reactions.size();
+    written &= fwrite(species.data(), sizeof(BinarySpecies), species.size(), fp) == species.size();
+    written &= fwrite(instructions.data(), sizeof(BinaryInstruction), instructions.size(), fp) == instructions.size();
+    written &= fwrite(offsets.data(), sizeof(uint32_t), offsets.size(), fp) == offsets.size();
+    written &= fwrite(names.data(), 1, names.size(), fp) == names.size();
+    written &= fclose(fp) == 0;
+
+    if (!written)
+        throw std::runtime_error("The file could not be written");
+}
+
+void Model::resolve()
+{
+    for (auto &&r : m_reactions)
+        compute_probabilities(r);
+
+    const std::map<int, std::tuple<int, int, int>> map_instructions = __map_instructions();
+
+    std::set<int> set_ident;
+
+    for (auto &&r : m_reactions)
+        set_ident.insert({r.ident, r.substrate, r.product});
+
+    for (auto &&i : map_instructions)
+        set_ident.insert(i.first);
+
+    // Build the species table, sorted by identifier
+    m_species.clear();
+
+    for (auto &&ident : set_ident)
+    {
+        Species species;
+        species.ident = ident;
+
+        auto data = map_instructions.find(ident);
+        if (data != map_instructions.end())
+        {
+            species.count = std::get<0>(data->second);
+            species.diameter = std::get<1>(data->second) ? std::get<1>(data->second) : species.diameter;
+            species.speed = std::get<2>(data->second) ? std::get<2>(data->second) : species.speed;
+        }
+
+        m_species.push_back(species);
+    }
+
+    __build_reaction_table();
+}
+
+void Model::compute_probabilities(react &reaction)
+{
+    // [p3]: Es -> E + p
+    reaction.p3 = reaction.kcat / 10000;
+
+    // [p2]: Es -> E + s
+    reaction.p2 = reaction.p3 / 10;
+
+    // [p1]: E + s -> Es
+    const float p2 = reaction.p2, p3 = reaction.p3;
+    reaction.p1 = (p2 + p3) / (.448 * (1 + (p2 + p3) * (p2 + p3)) * reaction.mM);
+}
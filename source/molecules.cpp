@@ -0,0 +1,110 @@
+#include "../include/molecules.hpp"
+
+// METHODS
+size_t MoleculeStore::size() const
+{
+    return m_species.size();
+}
+
+void MoleculeStore::reserve(size_t n)
+{
+    m_x.reserve(n);
+    m_y.reserve(n);
+    m_z.reserve(n);
+    m_diameter.reserve(n);
+    m_speed.reserve(n);
+    m_species.reserve(n);
+    m_reaction.reserve(n);
+    m_flags.reserve(n);
+}
+
+int MoleculeStore::push_back(int species, float diameter, float speed, const Coord &position)
+{
+    m_x.push_back(position.x);
+    m_y.push_back(position.y);
+    m_z.push_back(position.z);
+    m_diameter.push_back(diameter);
+    m_speed.push_back(speed);
+    m_species.push_back(species);
+    m_reaction.push_back(-1);
+    m_flags.push_back(0);
+
+    return m_species.size() - 1;
+}
+
+void MoleculeStore::remove(size_t i)
+{
+    m_flags[i] |= TO_DELETE | SEEN;
+}
+
+size_t MoleculeStore::compact(std::vector<unsigned int> *counts)
+{
+    const size_t n = size();
+    size_t w = 0;
+
+    for (size_t r = 0; r < n; r++)
+    {
+        if (m_flags[r] & TO_DELETE)
+        {
+            if (counts)
+                (*counts)[m_species[r]]--;
+
+            continue;
+        }
+
+        // Move the molecule down over the removed ones
+        if (w != r)
+        {
+            m_x[w] = m_x[r];
+            m_y[w] = m_y[r];
+            m_z[w] = m_z[r];
+            m_diameter[w] = m_diameter[r];
+            m_speed[w] = m_speed[r];
+            m_species[w] = m_species[r];
+            m_reaction[w] = m_reaction[r];
+        }
+
+        m_flags[w] = m_flags[r] & ~SEEN;
+        w++;
+    }
+
+    m_x.resize(w);
+    m_y.resize(w);
+    m_z.resize(w);
+    m_diameter.resize(w);
+    m_speed.resize(w);
+    m_species.resize(w);
+    m_reaction.resize(w);
+    m_flags.resize(w);
+
+    return n - w;
+}
+
+// ========================
+// ACCESSORS
+Coord MoleculeStore::position(size_t i) const
+{
+    return {m_x[i], m_y[i], m_z[i]};
+}
+
+void MoleculeStore::set_position(size_t i, const Coord &position)
+{
+    m_x[i] = position.x;
+    m_y[i] = position.y;
+    m_z[i] = position.z;
+}
+
+bool MoleculeStore::is(size_t i, Flag flag) const
+{
+    return m_flags[i] & flag;
+}
+
+void MoleculeStore::set(size_t i, Flag flag)
+{
+    m_flags[i] |= flag;
+}
+
+void MoleculeStore::unset(size_t i, Flag flag)
+{
+    m_flags[i] &= ~flag;
+}
@@ -7,8 +7,10 @@
 #include "../include/types.hpp"
 
 // 'PARSE' METHODS
-void Parser::parse(std::vector<UL> data_tokenized, std::vector<react> &reactions, std::vector<instr> &instructions)
+void Parser::parse(const std::vector<UL> &tokens, std::vector<react> &reactions, std::vector<instr> &instructions)
 {
+    TokenCursor data_tokenized = TokenCursor(tokens);
+
     while (data_tokenized.size() > 0)
     {
         switch (data_tokenized.at(0).type)
@@ -25,30 +27,30 @@ void Parser::parse(std::vector<UL> data_tokenized, std::vector<react> &reactions
             return;
 
         default:
-            data_tokenized.erase(data_tokenized.begin());
+            data_tokenized.advance();
             continue;
         }
     }
 }
 
-react Parser::reaction(std::vector<UL> &data_tokenized)
+react Parser::reaction(TokenCursor &data_tokenized)
 {
     react r;
 
     // Get enzyma
-    r.ident = next_token(data_tokenized, IDENT, "enzyma error");
+    r.ident = int(next_token(data_tokenized, IDENT, "enzyma error"));
 
     // Next symbol is colon
     next_symbol_except(data_tokenized, COLON, "syntax_error 0");
 
     // Get substrate
-    r.substrate = next_token(data_tokenized, IDENT, "substrate error");
+    r.substrate = int(next_token(data_tokenized, IDENT, "substrate error"));
 
     // Next symbol is arrow
     next_symbol_except(data_tokenized, ARROW, "syntax_error 1");
 
     // Get product
-    r.product = next_token(data_tokenized, IDENT, "product error");
+    r.product = int(next_token(data_tokenized, IDENT, "product error"));
 
     // Next symbol is arrow
     next_symbol_except(data_tokenized, VBAR, "syntax_error 2");
@@ -65,12 +67,12 @@ react Parser::reaction(std::vector<UL> &data_tokenized)
     next_symbol_except(data_tokenized, SEMICOLON, "syntax_error 4");
 
     if (data_tokenized.at(0).type == END)
-        data_tokenized.erase(data_tokenized.begin());
+        data_tokenized.advance();
 
     return r;
 }
 
-instr Parser::instruction(std::vector<UL> &data_tokenized)
+instr Parser::instruction(TokenCursor &data_tokenized)
 {
     instr i;
 
@@ -81,7 +83,7 @@ instr Parser::instruction(std::vector<UL> &data_tokenized)
     next_symbol_except(data_tokenized, PARENTHESIS_OPEN, "syntax_error");
 
     // Get the ident
-    i.ident = next_token(data_tokenized, IDENT, "ident error");
+    i.ident = int(next_token(data_tokenized, IDENT, "ident error"));
 
     // Next symbol is parenthesis close
     next_symbol_except(data_tokenized, PARENTHESIS_CLOSE, "syntax_error");
@@ -94,24 +96,24 @@ instr Parser::instruction(std::vector<UL> &data_tokenized)
 
     // If the instruction is diameter, multiply the value by 10
     if (i.type == Keyword::DIAMETER)
-        i.value *= 10;
+        i.value *= m_DIAMETER_SCALE;
 
     // If the instruction is speed, multiply the value by 5
     if (i.type == Keyword::SPEED)
-        i.value *= 5;
+        i.value *= m_SPEED_SCALE;
 
     // Next symbol is semicolon
     next_symbol_except(data_tokenized, SEMICOLON, "syntax_error");
 
     // Erase the end token if it exists
     if (data_tokenized.at(0).type == END)
-        data_tokenized.erase(data_tokenized.begin());
+        data_tokenized.advance();
 
     return i;
 }
 
 // 'SERIES' METHODS
-std::vector<react> Parser::reactions_series(std::vector<UL> data_tokenized)
+std::vector<react> Parser::reactions_series(TokenCursor data_tokenized)
 {
     std::vector<react> reactions;
 
@@ -125,7 +127,7 @@ std::vector<react> Parser::reactions_series(std::vector<UL> data_tokenized)
         catch (const std::exception &e)
         {
             printf("Error: %s\n", e.what());
-            data_tokenized.erase(data_tokenized.begin());
+            data_tokenized.advance();
             continue;
         }
     }
@@ -133,7 +135,7 @@ std::vector<react> Parser::reactions_series(std::vector<UL> data_tokenized)
     return reactions;
 }
 
-std::vector<instr> Parser::instructions_series(std::vector<UL> data_tokenized)
+std::vector<instr> Parser::instructions_series(TokenCursor data_tokenized)
 {
     std::vector<instr> instructions;
 
@@ -146,7 +148,7 @@ std::vector<instr> Parser::instructions_series(std::vector<UL> data_tokenized)
         }
         catch (const std::exception &e)
         {
-            data_tokenized.erase(data_tokenized.begin());
+            data_tokenized.advance();
             continue;
         }
     }
@@ -154,7 +156,7 @@ std::vector<instr> Parser::instructions_series(std::vector<UL> data_tokenized)
     return instructions;
 }
 
-std::tuple<float, float> Parser::idents_series(std::vector<UL> &data_tokenized)
+std::tuple<float, float> Parser::idents_series(TokenCursor &data_tokenized)
 {
     std::tuple<float, float> ident = {0, 0};
 
@@ -168,7 +170,7 @@ std::tuple<float, float> Parser::idents_series(std::vector<UL> &data_tokenized)
     return ident;
 }
 
-std::tuple<float, float> Parser::mM_series(std::vector<UL> &data_tokenized)
+std::tuple<float, float> Parser::mM_series(TokenCursor &data_tokenized)
 {
     std::tuple<float, float> mM = {0, 0};
     std::tuple<float, float> unit = {Unit::mM, Unit::mM};
@@ -194,13 +196,13 @@ std::tuple<float, float> Parser::mM_series(std::vector<UL> &data_tokenized)
 // ========================
 // 'NEXT' METHODS
 
-float Parser::next_token(std::vector<UL> &data_tokenized, State type, std::string exception)
+float Parser::next_token(TokenCursor &data_tokenized, State type, std::string exception)
 {
     // Check if the token is of the right type
     if (data_tokenized.at(0).type == type)
     {
         float tmp = data_tokenized.at(0).valeur;
-        data_tokenized.erase(data_tokenized.begin());
+        data_tokenized.advance();
         return tmp;
     }
 
@@ -208,13 +210,13 @@ float Parser::next_token(std::vector<UL> &data_tokenized, State type, std::strin
         throw std::runtime_error(exception);
 }
 
-bool Parser::next_symbol(std::vector<UL> &data_tokenized, Ponct symbol)
+bool Parser::next_symbol(TokenCursor &data_tokenized, Ponct symbol)
 {
     // Check if the next token is the correct ponctuation
     if (data_tokenized.at(0).type == PONCT and data_tokenized.at(0).valeur == symbol)
     {
         // Move to the next token
-        data_tokenized.erase(data_tokenized.begin());
+        data_tokenized.advance();
         return true;
     }
 
@@ -222,13 +224,13 @@ bool Parser::next_symbol(std::vector<UL> &data_tokenized, Ponct symbol)
         return false;
 }
 
-bool Parser::next_keyword(std::vector<UL> &data_tokenized, Keyword keyword)
+bool Parser::next_keyword(TokenCursor &data_tokenized, Keyword keyword)
 {
     // Check if the next token is the correct keyword
     if (data_tokenized.at(0).type == KEYWORD and data_tokenized.at(0).valeur == keyword)
     {
         // Move to the next token
-        data_tokenized.erase(data_tokenized.begin());
+        data_tokenized.advance();
         return true;
     }
 
@@ -236,7 +238,7 @@ bool Parser::next_keyword(std::vector<UL> &data_tokenized, Keyword keyword)
         return false;
 }
 
-void Parser::next_symbol_except(std::vector<UL> &data_tokenized, Ponct symbol, std::string exception)
+void Parser::next_symbol_except(TokenCursor &data_tokenized, Ponct symbol, std::string exception)
 {
     // Check if the next token is the correct ponctuation
     if (not next_symbol(data_tokenized, symbol))
@@ -0,0 +1,212 @@
+#include "../include/placement.hpp"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "../include/random.hpp"
+
+// CONSTRUCTORS
+Placement::Placement(float radius, float spacing, uint64_t seed) : m_radius(radius), m_spacing(spacing)
+{
+    // As many spheres as fit in the volume of the vesicle, along a cube
+    const double bounding_volume = (4.0 / 3.0) * M_PI * double(radius) * radius * radius;
+    const double sphere_volume = (4.0 / 3.0) * M_PI * double(spacing) * spacing * spacing / 8;
+
+    m_side = std::cbrt(std::floor(bounding_volume / sphere_volume));
+
+    const uint64_t side = std::ceil(m_side);
+    m_points = side * side * side;
+
+    // The domain of the permutation is the smallest power of 4 which holds all the points
+    while ((uint64_t(1) << (2 * m_half_bits)) < m_points)
+        m_half_bits++;
+
+    for (auto &&key : m_keys)
+        key = seed = mix_seed(seed);
+}
+
+// PRIVATE METHODS
+uint64_t Placement::__permute(uint64_t index) const
+{
+    const uint64_t mask = (uint64_t(1) << m_half_bits) - 1;
+    uint64_t left = index >> m_half_bits, right = index & mask;
+
+    for (auto &&key : m_keys)
+    {
+        const uint64_t next = left ^ (mix_seed(right ^ key) & mask);
+        left = right;
+        right = next;
+    }
+
+    return (left << m_half_bits) | right;
+}
+
+// METHODS
+Coord Placement::next()
+{
+    const uint64_t side = std::ceil(m_side);
+
+    while (m_visited < m_points)
+    {
+        // Walk the permutation until it falls in the lattice. Each index of the lattice is reached once
+        uint64_t index = __permute(m_visited++);
+        while (index >= m_points)
+            index = __permute(index);
+
+        const uint64_t x = index / (side * side), y = index / side % side, z = index % side;
+
+        const Coord position = {
+            (2 * x + 1 - m_side) * m_spacing / 2,
+            (2 * y + 1 - m_side) * m_spacing / 2,
+            (2 * z + 1 - m_side) * m_spacing / 2};
+
+        // Keep the points inside the vesicle
+        if (std::sqrt(position.x * position.x + position.y * position.y + position.z * position.z) <= m_radius)
+            return position;
+    }
+
+    throw std::runtime_error("The vesicle is too small for the molecules");
+}
+
+// ========================
+// PACKING
+// CONSTRUCTORS
+Packing::Packing(float vesicle_radius, float offset, uint64_t seed)
+    : m_seed(seed), m_vesicle_radius(vesicle_radius), m_offset(offset) {}
+
+// PRIVATE METHODS
+uint64_t Packing::__key(int64_t x, int64_t y, int64_t z)
+{
+    // 21 bits by axis, which holds a million cells on each side of the center
+    const uint64_t mask = (uint64_t(1) << 21) - 1;
+    return (uint64_t(x) & mask) << 42 | (uint64_t(y) & mask) << 21 | (uint64_t(z) & mask);
+}
+
+int Packing::__head(const Group &group, int64_t x, int64_t y, int64_t z) const
+{
+    if (group.side == 0)
+    {
+        auto head = group.heads.find(__key(x, y, z));
+        return head == group.heads.end() ? -1 : head->second;
+    }
+
+    // The cells of the array start at the lowest corner of the vesicle
+    const int64_t shift = group.side / 2;
+    x += shift, y += shift, z += shift;
+
+    if (x < 0 || y < 0 || z < 0 || x >= group.side || y >= group.side || z >= group.side)
+        return -1;
+
+    return group.cells[(x * group.side + y) * group.side + z];
+}
+
+void Packing::__index(float cell_size, Group &group)
+{
+    // An array of cells covers the vesicle, with a cell of margin on each side
+    if (group.indexed == 0 && group.cells.empty() && group.heads.empty())
+    {
+        const double side = 2 * std::ceil(m_vesicle_radius / cell_size) + 2;
+
+        if (side * side * side <= m_MAX_CELLS)
+        {
+            group.side = side;
+            group.cells.assign(group.side * group.side * group.side, -1);
+        }
+    }
+
+    for (; group.indexed < group.positions.size(); group.indexed++)
+    {
+        const int m = group.indexed;
+        const int64_t x = int64_t(std::floor(group.positions[m].x / cell_size));
+        const int64_t y = int64_t(std::floor(group.positions[m].y / cell_size));
+        const int64_t z = int64_t(std::floor(group.positions[m].z / cell_size));
+
+        if (group.side == 0)
+        {
+            auto head = group.heads.emplace(__key(x, y, z), -1).first;
+            group.next.push_back(head->second);
+            head->second = m;
+        }
+
+        else
+        {
+            const int64_t shift = group.side / 2;
+            int &head = group.cells[((x + shift) * group.side + y + shift) * group.side + z + shift];
+            group.next.push_back(head);
+            head = m;
+        }
+    }
+}
+
+bool Packing::__overlaps(const Coord &position, float diameter)
+{
+    for (auto &&g : m_groups)
+    {
+        const float cell_size = g.first;
+        Group &group = g.second;
+
+        // The points of a lattice never overlap
+        if (cell_size == diameter || group.positions.empty())
+            continue;
+
+        __index(cell_size, group);
+
+        // The cells of the box around the molecule which can hold a molecule closer than the sum of the two radii
+        const float limit = (diameter + cell_size) / 2;
+        const float distance = limit * (1 - m_TOLERANCE);
+
+        auto first = [&](float x)
+        { return int64_t(std::floor((x - limit) / cell_size)); };
+        auto last = [&](float x)
+        { return int64_t(std::floor((x + limit) / cell_size)); };
+
+        for (int64_t x = first(position.x); x <= last(position.x); x++)
+            for (int64_t y = first(position.y); y <= last(position.y); y++)
+                for (int64_t z = first(position.z); z <= last(position.z); z++)
+                    for (int m = __head(group, x, y, z); m != -1; m = group.next[m])
+                    {
+                        const float dx = group.positions[m].x - position.x;
+                        const float dy = group.positions[m].y - position.y;
+                        const float dz = group.positions[m].z - position.z;
+
+                        if (dx * dx + dy * dy + dz * dz < distance * distance)
+                            return true;
+                    }
+    }
+
+    return false;
+}
+
+// METHODS
+Coord Packing::place(float diameter)
+{
+    if (!(diameter > 0))
+        throw std::runtime_error("The diameter of the molecules must be positive");
+
+    // The group of the diameter, with its own lattice and order of the points
+    auto g = m_groups.find(diameter);
+    if (g == m_groups.end())
+    {
+        uint32_t bits;
+        memcpy(&bits, &diameter, sizeof(bits));
+
+        const float radius = m_vesicle_radius - diameter / 2 - m_offset;
+
+        g = m_groups.emplace(diameter, Group()).first;
+        g->second.lattice = Placement(radius, diameter, mix_seed(m_seed ^ bits));
+    }
+
+    Group &group = g->second;
+
+    for (;;)
+    {
+        // Throws when the lattice is exhausted
+        const Coord position = group.lattice.next();
+
+        if (__overlaps(position, diameter))
+            continue;
+
+        group.positions.push_back(position);
+        return position;
+    }
+}
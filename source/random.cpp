@@ -0,0 +1,45 @@
+#include "../include/random.hpp"
+
+// ========================
+// PHILOX
+void Philox::fill(uint64_t stream, uint64_t first, size_t count, uint32_t *out) const
+{
+    for (size_t i = 0; i < count; i++)
+        draw(stream, first + i, out + 4 * i);
+}
+
+// ========================
+// XOSHIRO256
+Xoshiro256::Xoshiro256(uint64_t seed, uint64_t stream)
+{
+    // Expand the seed with splitmix64, as recommended by the authors
+    uint64_t x = seed;
+    for (auto &&s : m_state)
+    {
+        s = mix_seed(x);
+        x += 0x9E3779B97F4A7C15ull;
+    }
+
+    for (uint64_t i = 0; i < stream; i++)
+        jump();
+}
+
+void Xoshiro256::jump()
+{
+    static const uint64_t JUMP[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+
+    uint64_t s[4] = {0, 0, 0, 0};
+
+    for (auto &&j : JUMP)
+        for (int b = 0; b < 64; b++)
+        {
+            if (j & (uint64_t(1) << b))
+                for (int i = 0; i < 4; i++)
+                    s[i] ^= m_state[i];
+
+            (*this)();
+        }
+
+    for (int i = 0; i < 4; i++)
+        m_state[i] = s[i];
+}
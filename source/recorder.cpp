@@ -0,0 +1,172 @@
+#include "../include/recorder.hpp"
+#include <cstring>
+#include <stdexcept>
+
+// CONSTRUCTORS
+Recorder::Recorder(const std::string &path, Format format, const std::vector<std::string> &names, unsigned int interval)
+    : m_format(format), m_n_species(names.size()), m_path(path), m_interval(interval ? interval : 1)
+{
+    m_file = fopen(path.c_str(), format == BINARY ? "wb" : "w");
+
+    if (m_file == NULL)
+        throw std::runtime_error("The file " + path + " could not be opened");
+
+    // Write the header
+    bool written = true;
+
+    if (m_format == BINARY)
+    {
+        const uint32_t header[] = {m_VERSION, uint32_t(names.size())};
+        written &= fwrite("TERS", 1, 4, m_file) == 4;
+        written &= fwrite(header, sizeof(uint32_t), 2, m_file) == 2;
+
+        for (auto &&name : names)
+        {
+            const uint32_t length = name.size();
+            written &= fwrite(&length, sizeof(uint32_t), 1, m_file) == 1;
+            written &= fwrite(name.data(), 1, length, m_file) == length;
+        }
+    }
+
+    else
+    {
+        written &= fprintf(m_file, "tick,time") >= 0;
+        for (auto &&name : names)
+            written &= fprintf(m_file, ",\"%s\"", name.c_str()) >= 0;
+        written &= fprintf(m_file, "\n") >= 0;
+    }
+
+    if (!written)
+    {
+        fclose(m_file);
+        throw std::runtime_error("The file " + path + " could not be written");
+    }
+
+    m_writer = std::thread(&Recorder::__write, this);
+}
+
+Recorder::~Recorder()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception &)
+    {
+    }
+}
+
+// ========================
+// METHODS
+void Recorder::record(unsigned int tick, uint64_t time, const std::vector<unsigned int> &counts)
+{
+    if (tick % m_interval != 0)
+        return;
+
+    bool wake = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_error.empty())
+            throw std::runtime_error(m_error);
+
+        m_pending.push_back(tick);
+
+        // The time is copied as is, so the binary rows hold it as a uint64 in the byte order of the machine
+        uint32_t words[2];
+        memcpy(words, &time, sizeof(time));
+        m_pending.insert(m_pending.end(), words, words + 2);
+
+        m_pending.insert(m_pending.end(), counts.begin(), counts.end());
+
+        wake = m_pending.size() >= m_FLUSH_SIZE;
+    }
+
+    if (wake)
+        m_wake.notify_one();
+}
+
+void Recorder::close()
+{
+    if (m_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_one();
+        m_writer.join();
+    }
+
+    // The rows buffered by the file are only written when it is closed
+    if (m_file)
+    {
+        const bool closed = fclose(m_file) == 0;
+        m_file = nullptr;
+
+        if (!closed && m_error.empty())
+            m_error = "The file " + m_path + " could not be written";
+    }
+
+    if (!m_error.empty())
+        throw std::runtime_error(m_error);
+}
+
+// ========================
+// PRIVATE METHODS
+void Recorder::__write()
+{
+    std::vector<uint32_t> rows;
+
+    for (;;)
+    {
+        bool stop = false;
+
+        // Take the pending rows, and give back an empty buffer to the simulation
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]
+                        { return m_stop || m_pending.size() >= m_FLUSH_SIZE; });
+
+            rows.swap(m_pending);
+            stop = m_stop;
+        }
+
+        // Keep the first error, the next rows are not written
+        if (!rows.empty() && m_error.empty() && !__write_rows(rows))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = "The file " + m_path + " could not be written";
+        }
+
+        rows.clear();
+
+        if (stop)
+            return;
+    }
+}
+
+bool Recorder::__write_rows(const std::vector<uint32_t> &rows)
+{
+    if (m_format == BINARY)
+        return fwrite(rows.data(), sizeof(uint32_t), rows.size(), m_file) == rows.size();
+
+    bool written = true;
+
+    const size_t width = 3 + m_n_species;
+
+    for (size_t r = 0; r + width <= rows.size(); r += width)
+    {
+        uint64_t time;
+        memcpy(&time, &rows[r + 1], sizeof(time));
+
+        written &= fprintf(m_file, "%u,%llu", rows[r], (unsigned long long)time) >= 0;
+        for (size_t c = 3; c < width; c++)
+            written &= fprintf(m_file, ",%u", rows[r + c]) >= 0;
+        written &= fprintf(m_file, "\n") >= 0;
+    }
+
+    return written;
+}
@@ -0,0 +1,128 @@
+#include "../include/runner.hpp"
+#include <algorithm>
+
+// ========================
+// CONSTRUCTORS
+Runner::Runner(Simulation &simulation) : m_simulation(simulation)
+{
+    m_snapshots.back().capture(m_simulation);
+    m_snapshots.publish();
+
+    m_thread = std::thread(&Runner::__run, this);
+}
+
+Runner::~Runner()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+// ========================
+// PRIVATE METHODS
+void Runner::__run()
+{
+    for (;;)
+    {
+        bool last;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]
+                        { return m_stop || m_ticks_left > 0 || (m_uncapped && !m_paused); });
+
+            if (m_stop)
+                return;
+
+            if (m_ticks_left > 0)
+                m_ticks_left--;
+
+            last = m_ticks_left == 0 && !(m_uncapped && !m_paused);
+        }
+
+        m_simulation.move_all_molecules();
+
+        // The last tick of a frame is always shown. Otherwise, the tick is only copied if the view has drawn the previous one
+        if (last || m_snapshots.consumed())
+        {
+            m_snapshots.back().capture(m_simulation);
+            m_snapshots.publish();
+        }
+    }
+}
+
+// ========================
+// METHODS
+void Runner::frame()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // The ticks of a frame which are not done yet are dropped, so a slow simulation never lags behind
+        if (!m_paused && !m_uncapped)
+            m_ticks_left = m_ticks_per_frame;
+    }
+
+    m_wake.notify_one();
+}
+
+void Runner::step_once()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ticks_left += 1;
+    }
+
+    m_wake.notify_one();
+}
+
+void Runner::set_ticks_per_frame(unsigned int ticks)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ticks_per_frame = std::min(std::max(ticks, 1u), m_MAX_TICKS_PER_FRAME);
+}
+
+void Runner::set_uncapped(bool uncapped)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_uncapped = uncapped;
+    }
+
+    m_wake.notify_one();
+}
+
+void Runner::set_paused(bool paused)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = paused;
+
+        if (paused)
+            m_ticks_left = 0;
+    }
+
+    m_wake.notify_one();
+}
+
+unsigned int Runner::ticks_per_frame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ticks_per_frame;
+}
+
+bool Runner::uncapped()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_uncapped;
+}
+
+bool Runner::paused()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_paused;
+}
@@ -1,116 +1,82 @@
 #include "../include/simulation.hpp"
+#include <cstring>
 #include <stdexcept>
 
 // PRIVATE METHODS
-
-std::map<int, std::tuple<int, int, int>> Simulation::__map_instructions()
+int Simulation::__is_hit(size_t m)
 {
-    // Ident: {Count, Diameter, Speed}
-    std::map<int, std::tuple<int, int, int>> map;
+    int hit = -1;
 
-    for (int i = 0; i < m_instructions.size(); i++)
-    {
-        switch (m_instructions[i].type)
-        {
-        case Keyword::INIT:
-            if (map.find(m_instructions[i].ident) != map.end())
-                std::get<0>(map[m_instructions[i].ident]) += m_instructions[i].value;
-            else
-                map[m_instructions[i].ident] = {m_instructions[i].value, 0, 0};
-
-            continue;
+    const Coord position = m_molecules.position(m);
+    const int cx = m_grid.axis(position.x);
+    const int cy = m_grid.axis(position.y);
+    const int cz = m_grid.axis(position.z);
 
-        case Keyword::DIAMETER:
-            if (map.find(m_instructions[i].ident) != map.end())
-                std::get<1>(map[m_instructions[i].ident]) = m_instructions[i].value;
-            else
-                map[m_instructions[i].ident] = {0, m_instructions[i].value, 0};
+    const float radius = m_molecules.m_diameter[m] / 2;
 
-            continue;
+    // Only the molecules of the neighbouring cells can be close enough to collide.
+    // The cells along z are contiguous in the grid, so the 3 cells of a column are scanned at once
+    const int z0 = std::max(0, cz - 1), z1 = std::min(m_grid.m_cells - 1, cz + 1);
 
-        case Keyword::SPEED:
-            if (map.find(m_instructions[i].ident) != map.end())
-                std::get<2>(map[m_instructions[i].ident]) = m_instructions[i].value;
-            else
-                map[m_instructions[i].ident] = {0, 0, m_instructions[i].value};
+    for (int x = std::max(0, cx - 1); x <= std::min(m_grid.m_cells - 1, cx + 1); x++)
+        for (int y = std::max(0, cy - 1); y <= std::min(m_grid.m_cells - 1, cy + 1); y++)
+        {
+            const int begin = m_grid.m_cell_start[m_grid.cell(x, y, z0)];
+            const int end = m_grid.m_cell_start[m_grid.cell(x, y, z1) + 1];
 
-            continue;
+            for (int k = begin; k < end; k++)
+            {
+                // Compare the squared distance with the squared mean diameter, from the copies sorted by cell
+                const float dx = m_grid.m_x[k] - position.x;
+                const float dy = m_grid.m_y[k] - position.y;
+                const float dz = m_grid.m_z[k] - position.z;
+                const float limit = radius + m_grid.m_radius[k];
+
+                if (dx * dx + dy * dy + dz * dz >= limit * limit)
+                    continue;
+
+                // Keep the lowest index, as the linear scan did
+                const int i = m_grid.m_indices[k];
+                if (hit != -1 && i > hit)
+                    continue;
+
+                // If the molecule has already been seen, skip it
+                // If the molecule is the same as the current molecule, skip it
+                if (m_molecules.is(i, SEEN))
+                    continue;
+
+                hit = i;
+            }
         }
-    }
-
-    return map;
-}
-
-Coord Simulation::__rand_movement(const Coord &position, float speed)
-{
-    // Generate a random angle in radians
-    float angle = (rand() % 360) * M_PI / 180;
-
-    float x_new = position.x + speed * cos(angle);
-    float y_new = position.y + speed * sin(angle);
-    float z_new = position.z + speed * (rand() % 2 == 0 ? 1 : -1);
-
-    return {x_new, y_new, z_new};
-}
-
-int Simulation::__is_hit(const Molecule &m)
-{
-    for (size_t i = 0; i < m_molecules.size(); i++)
-    {
-        // If the molecule has already been seen, skip it
-        // If the molecule is the same as the current molecule, skip it
-        if (m_molecules[i].is_seen)
-            continue;
-
-        if (__distance(m.position, m_molecules[i].position) < (m.diameter + m_molecules[i].diameter) / 2)
-            return i;
-    }
 
-    return -1;
+    return hit;
 }
 
-bool Simulation::__is_reacting(Molecule &molecule, Molecule &molecule_hit, react &reaction)
+int Simulation::__is_reacting(size_t molecule, size_t molecule_hit)
 {
-    for (const react &r : m_reactions)
-    {
-        // Check if molecule is an enzyme and the hit is a substrate
-        const bool molecule_is_reacting = r.ident == molecule.ident && r.substrate == molecule_hit.ident;
-
-        // Check if hit is an enzyme and the molecule is a substrate
-        const bool hit_is_reacting = r.ident == molecule_hit.ident && r.substrate == molecule.ident;
-
-        if (molecule_is_reacting || hit_is_reacting)
-        {
-            reaction = r;
-            return true;
-        }
-    }
+    const size_t n_species = m_species.size();
 
-    return false;
+    return m_model->m_reaction_table[m_molecules.m_species[molecule] * n_species + m_molecules.m_species[molecule_hit]];
 }
 
-void Simulation::__reacting_fusion(Molecule &enzyme, Molecule &substrate, const react &reaction)
+void Simulation::__reacting_fusion(size_t enzyme, size_t substrate, int reaction)
 {
-    enzyme.reaction = reaction;
-    substrate.to_delete = true;
-    substrate.is_seen = true;
+    m_molecules.m_reaction[enzyme] = reaction;
+    m_molecules.remove(substrate);
 }
 
-void Simulation::__reacting_unfusion(Molecule &enzyme, const int &ident_product)
+void Simulation::__reacting_unfusion(size_t enzyme, int species_product, std::vector<std::pair<int, Coord>> &products)
 {
-    std::tuple<int, int, int> product_data = m_map_instructions[ident_product];
+    const Species &product = m_species[species_product];
 
-    // Create the product molecule
-    Molecule product = Molecule(ident_product);
-    product.diameter = std::get<1>(product_data) ? std::get<1>(product_data) : product.diameter;
-    product.speed = std::get<2>(product_data) ? std::get<2>(product_data) : product.speed;
-    product.is_seen = true;
-    product.position = enzyme.position + enzyme.diameter / 2 + product.diameter / 2;
-    m_molecules.push_back(product);
+    // Create the product molecule in contact with the enzyme along the x axis, it is added to the molecules at the end of the tick
+    Coord position = m_molecules.position(enzyme);
+    position.x += m_molecules.m_diameter[enzyme] / 2 + product.diameter / 2;
+    products.push_back({species_product, position});
 
     // Reset the enzyme
-    enzyme.reaction = {};
-    enzyme.is_seen = true;
+    m_molecules.m_reaction[enzyme] = -1;
+    m_molecules.set(enzyme, SEEN);
 }
 
 float Simulation::__distance(const Coord &a, const Coord &b)
@@ -118,27 +84,13 @@ float Simulation::__distance(const Coord &a, const Coord &b)
     return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
 }
 
-float Simulation::__compute_probability_1(const react &reaction, const float &p2, const float &p3)
-{
-    return (p2 + p3) / (.448 * (1 + (p2 + p3) * (p2 + p3)) * reaction.mM);
-}
-
-float Simulation::__compute_probability_2(const react &reaction, const float &p3)
-{
-    return p3 / 10;
-}
-
-float Simulation::__compute_probability_3(const react &reaction)
-{
-    return reaction.kcat / 10000;
-}
-
 // ========================
 // INITIALIZATION METHODS
-void Simulation::init(char *data_path)
+void Simulation::init(std::shared_ptr<const Model> model)
 {
-    // Read the file and parse it, to get the instructions and reactions of the simulation
-    read_file(data_path);
+    // Keep the model, and copy its reactions
+    init_model(model);
+    m_philox = Philox(m_seed);
 
     // Initialize the attributes of the simulation
     init_max_diameter();
@@ -146,209 +98,306 @@ void Simulation::init(char *data_path)
     init_equidistant_positions();
     init_molecules();
     init_reactions();
+    init_grid();
 }
 
 void Simulation::init_max_diameter()
 {
-    for (auto &&i : m_instructions)
-        if (i.type == Keyword::DIAMETER)
-            max_diameter = std::max(max_diameter, i.value);
-}
+    // The diameters of the overrides replace those of the instructions
+    auto overridden = [this](int ident)
+    {
+        for (auto &&o : m_overrides)
+            if (o.parameter == DIAMETER_OF && o.target == ident)
+                return true;
 
-void Simulation::init_count_molecules()
-{
-    std::set<float> set_ident;
+        return false;
+    };
 
-    for (auto &&r : m_reactions)
-        set_ident.insert({r.ident, r.substrate, r.product});
+    for (auto &&i : m_model->m_instructions)
+        if (i.type == Keyword::DIAMETER && !overridden(i.ident))
+            max_diameter = std::max(max_diameter, i.value);
 
-    m_ident_molecules = std::vector<int>(set_ident.begin(), set_ident.end());
+    for (auto &&o : m_overrides)
+        if (o.parameter == DIAMETER_OF)
+            max_diameter = std::max(max_diameter, o.value * Parser::m_DIAMETER_SCALE);
 }
 
 void Simulation::init_equidistant_positions()
 {
     float offset = 10;
-    float vesicle_radius = vesicle_diameter / 2 - max_diameter / 2 - offset;
-    float bounding_volume = (4.0 / 3.0) * M_PI * vesicle_radius * vesicle_radius * vesicle_radius;
-
-    // Compute the volume of a molecule (sphere)
-    float molecule_volume = (4.0 / 3.0) * M_PI * max_diameter * max_diameter * max_diameter / 8;
-    int n_spheres = static_cast<int>(bounding_volume / molecule_volume);
-
-    // Use a cubic grid to place the spheres
-    // The distance between the centers of two adjacent spheres is equal to the diameter of the sphere
-    float sphere_distance = max_diameter;
-    float cube_root_n = std::cbrt(n_spheres);
-    for (int x = 0; x < cube_root_n; ++x)
-    {
-        for (int y = 0; y < cube_root_n; ++y)
-        {
-            for (int z = 0; z < cube_root_n; ++z)
-            {
-                // Compute the position of the sphere
-                const Coord &sphere = {
-                    (2 * x + 1 - cube_root_n) * sphere_distance / 2,
-                    (2 * y + 1 - cube_root_n) * sphere_distance / 2,
-                    (2 * z + 1 - cube_root_n) * sphere_distance / 2};
-
-                // Check if the sphere is inside the vesicle
-                if (__distance(sphere, Coord()) <= vesicle_radius)
-                    m_start_positions.push_back(sphere);
-            }
-        }
-    }
 
-    std::shuffle(m_start_positions.begin(), m_start_positions.end(), std::default_random_engine());
+    m_packing = Packing(vesicle_diameter / 2, offset, m_seed);
 }
 
 void Simulation::init_molecules()
 {
-    m_map_instructions = __map_instructions();
-    int idx = 0;
-    int type_molecule = 0;
+    m_counts.assign(m_species.size(), 0);
+
+    // Place the largest molecules first, so the small ones fill the space left between them
+    std::vector<int> order(m_species.size());
+    for (size_t s = 0; s < order.size(); s++)
+        order[s] = s;
+
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b)
+                     { return m_species[a].diameter > m_species[b].diameter; });
+
+    std::vector<std::vector<Coord>> positions(m_species.size());
+    for (auto &&s : order)
+        for (int j = 0; j < m_species[s].count; j++)
+            positions[s].push_back(m_packing.place(m_species[s].diameter));
 
-    for (auto &&i : m_map_instructions)
+    // The molecules are stored in the order of the species
+    for (size_t s = 0; s < m_species.size(); s++)
     {
-        for (int j = 0; j < std::get<0>(i.second); j++)
-        {
-            Molecule molecule = Molecule(i.first);
-            molecule.name = m_ident_molecules[type_molecule];
-            molecule.diameter = std::get<1>(i.second) ? std::get<1>(i.second) : molecule.diameter;
-            molecule.speed = std::get<2>(i.second) ? std::get<2>(i.second) : molecule.speed;
-            molecule.position = m_start_positions[idx];
-
-            m_molecules.push_back(molecule);
-            idx++;
-        }
+        const Species &species = m_species[s];
+        m_molecules.reserve(m_molecules.size() + species.count);
+        m_counts[s] = species.count;
 
-        type_molecule++;
+        for (auto &&position : positions[s])
+            m_molecules.push_back(s, species.diameter, species.speed, position);
     }
+
+    // The packing is only needed to place the molecules
+    m_packing = Packing();
 }
 
 void Simulation::init_reactions()
 {
-    for (auto &&r : m_reactions)
+    // The table of the reactions between each pair of species is shared through the model,
+    // only the probabilities depend on the overrides of the run
+    init_probabilities();
+}
+
+void Simulation::init_grid()
+{
+    // A collision happens under the mean diameter of the two molecules, at most the largest diameter
+    m_grid.init(vesicle_diameter, std::max(max_diameter, Species().diameter));
+}
+
+void Simulation::move_all_molecules()
+{
+    // The molecules not seen yet keep their position during the tick, so the grid stays valid for them
+    m_grid.build(m_molecules);
+    __propose_moves();
+
+    std::vector<std::pair<int, Coord>> products;
+
+    if (m_pool)
+        __move_parallel(products);
+
+    else
+        for (size_t i = 0; i < m_molecules.size(); i++)
+        {
+            size_t reverse_i = m_molecules.size() - i - 1;
+
+            if (__move_molecule(m_inverse_direction ? reverse_i : i, products))
+                m_time += 1;
+        }
+
+    // Remove the fused molecules and reset the seen flag, then add the products of the tick
+    m_molecules.compact(&m_counts);
+    m_molecules.reserve(m_molecules.size() + products.size());
+
+    for (auto &&p : products)
     {
-        r.p3 = __compute_probability_3(r);
-        r.p2 = __compute_probability_2(r, r.p3);
-        r.p1 = __compute_probability_1(r, r.p2, r.p3);
+        const Species &species = m_species[p.first];
+        m_molecules.push_back(p.first, species.diameter, species.speed, p.second);
+        m_counts[p.first]++;
     }
+
+    m_inverse_direction = !m_inverse_direction;
+    m_tick += 1;
 }
 
-void Simulation::move_all_molecules()
+void Simulation::step()
 {
-    for (size_t i = 0; i < m_molecules.size(); i++)
+    move_all_molecules();
+}
+
+bool Simulation::is_idle() const
+{
+    return m_molecules.size() == 0;
+}
+
+void Simulation::set_threads(unsigned int threads)
+{
+    if (threads == 0)
+        m_pool.reset();
+
+    else
+        m_pool = std::make_shared<ThreadPool>(threads);
+}
+
+// ========================
+// STEPPING METHODS
+void Simulation::__propose_moves()
+{
+    // Each molecule has its own stream of random numbers, made of its index and of the tick
+    m_moves.resize(m_molecules.size());
+
+    const size_t chunk = 4096;
+    const size_t n_chunks = (m_molecules.size() + chunk - 1) / chunk;
+
+    auto fill = [this, chunk](size_t c)
     {
-        size_t reverse_i = m_molecules.size() - i - 1;
-        Molecule &m = m_molecules[m_inverse_direction ? reverse_i : i];
+        const size_t first = c * chunk;
+        const size_t count = std::min(chunk, m_molecules.size() - first);
+        propose_moves(m_molecules, m_philox, m_tick, vesicle_diameter / 2, first, count, m_moves);
+    };
 
-        // If the molecule has already been seen, skip it
-        if (m.is_seen)
-            continue;
+    if (m_pool)
+        m_pool->parallel_for(n_chunks, fill);
 
-        // Mark the molecule as seen
-        m.is_seen = true;
+    else
+        for (size_t c = 0; c < n_chunks; c++)
+            fill(c);
+}
 
-        // Generate a new position for the molecule
-        Coord new_pos = __rand_movement(m.position, m.speed);
+bool Simulation::__move_molecule(size_t m, std::vector<std::pair<int, Coord>> &products)
+{
+    // If the molecule has already been seen, skip it
+    if (m_molecules.is(m, SEEN))
+        return false;
 
-        // If the molecule is outside the vesicle, skip it
-        if (__distance(new_pos, Coord()) > vesicle_diameter / 2 - m.diameter / 2)
-            continue;
+    // Mark the molecule as seen
+    m_molecules.set(m, SEEN);
 
-        // Check if the molecule has collided with another molecule
-        int id_hit = __is_hit(m);
+    // If the new position of the molecule is outside the vesicle, skip it
+    if (!m_moves.m_inside[m])
+        return false;
 
-        // Pull a random number to check if a reaction can occur
-        float proba_react = static_cast<float>(rand()) / RAND_MAX;
+    Coord new_pos = {m_moves.m_x[m], m_moves.m_y[m], m_moves.m_z[m]};
 
-        if (m.reaction.ident != -1)
+    // Check if the molecule has collided with another molecule
+    int id_hit = __is_hit(m);
+
+    // Pull a random number to check if a reaction can occur
+    float proba_react = m_moves.m_proba[m];
+
+    if (m_molecules.m_reaction[m] != -1)
+    {
+        const react &bound = m_reactions[m_molecules.m_reaction[m]];
+
+        // Reaction: ES -> E + P
+        if (proba_react <= bound.p2)
         {
-            // Reaction: ES -> E + P
-            if (proba_react <= m.reaction.p2)
-            {
-                __reacting_unfusion(m, m.reaction.product);
-                continue;
-            }
+            __reacting_unfusion(m, bound.product, products);
+            return false;
+        }
 
-            // Reaction: ES -> E + S
-            if (m.reaction.p2 < proba_react <= m.reaction.p3)
-            {
-                __reacting_unfusion(m, m.reaction.substrate);
-                continue;
-            }
+        // Reaction: ES -> E + S
+        if (proba_react <= bound.p3)
+        {
+            __reacting_unfusion(m, bound.substrate, products);
+            return false;
         }
+    }
 
-        // If the molecule has not collided with another molecule, update its position
-        if (id_hit == -1)
-            m.position = new_pos;
+    // If the molecule has not collided with another molecule, update its position
+    if (id_hit == -1)
+        m_molecules.set_position(m, new_pos);
 
-        // Else, check if a reaction can occur
-        else
-        {
-            react reaction;
-            Molecule &molecule_hit = m_molecules[id_hit];
+    // Else, check if a reaction can occur
+    else
+    {
+        const int reaction = __is_reacting(m, id_hit);
 
-            if (__is_reacting(m, molecule_hit, reaction))
+        if (reaction != -1)
+        {
+            // Reaction: E + S -> ES
+            // A bound molecule cannot bind again: the enzyme would lose its substrate, or the removed substrate its own
+            if (m_molecules.m_reaction[m] == -1 && m_molecules.m_reaction[id_hit] == -1 && proba_react < m_reactions[reaction].p1)
             {
-                // Reaction: E + S -> ES
-                if (m.reaction.ident == -1 && proba_react < reaction.p1)
-                {
-                    // m is the enzyme
-                    if (m.ident == reaction.ident)
-                        __reacting_fusion(m, molecule_hit, reaction);
-
-                    // molecule_hit is the enzyme
-                    else
-                        __reacting_fusion(molecule_hit, m, reaction);
-                }
-            }
+                // m is the enzyme
+                if (m_molecules.m_species[m] == m_reactions[reaction].ident)
+                    __reacting_fusion(m, id_hit, reaction);
 
-            // If no reaction can occur, update the position of the molecule
-            else
-                m.position = new_pos;
+                // molecule_hit is the enzyme
+                else
+                    __reacting_fusion(id_hit, m, reaction);
+            }
         }
 
-        m_time += 1;
+        // If no reaction can occur, update the position of the molecule
+        else
+            m_molecules.set_position(m, new_pos);
     }
 
-    // Reset the is_seen attribute of all molecules
+    return true;
+}
+
+void Simulation::__move_parallel(std::vector<std::pair<int, Coord>> &products)
+{
+    // Cut the grid in cubic domains of m_DOMAIN_CELLS cells along each axis
+    const int n = (m_grid.m_cells + m_DOMAIN_CELLS - 1) / m_DOMAIN_CELLS;
+    const size_t n_domains = size_t(n) * n * n;
+
+    // Bucket the molecules by domain, keeping the indices sorted inside each domain
+    std::vector<int> domains(m_molecules.size());
+    m_domain_start.assign(n_domains + 1, 0);
+
     for (size_t i = 0; i < m_molecules.size(); i++)
     {
-        if (m_molecules[i].to_delete)
-        {
-            m_molecules.erase(m_molecules.begin() + i);
-            i--;
-        }
+        const int dx = m_grid.axis(m_molecules.m_x[i]) / m_DOMAIN_CELLS;
+        const int dy = m_grid.axis(m_molecules.m_y[i]) / m_DOMAIN_CELLS;
+        const int dz = m_grid.axis(m_molecules.m_z[i]) / m_DOMAIN_CELLS;
 
-        else
-            m_molecules[i].is_seen = false;
+        domains[i] = (dx * n + dy) * n + dz;
+        m_domain_start[domains[i] + 1]++;
     }
 
-    m_inverse_direction = !m_inverse_direction;
-}
+    for (size_t d = 1; d < m_domain_start.size(); d++)
+        m_domain_start[d] += m_domain_start[d - 1];
 
-// ========================
-// OTHER METHODS
+    m_domain_molecules.resize(m_molecules.size());
+    std::vector<int> cursor(m_domain_start.begin(), m_domain_start.end() - 1);
+    for (size_t i = 0; i < m_molecules.size(); i++)
+        m_domain_molecules[cursor[domains[i]]++] = i;
 
-void Simulation::read_file(char *data_path)
-{
-    FILE *fp = fopen(data_path, "r");
+    // Colour the domains with the parity of their coordinates.
+    // Two domains of the same colour are separated by a whole domain along one axis at least,
+    // so the cells they read and the molecules they can hit never overlap
+    std::vector<int> colours[8];
+    for (size_t d = 0; d < n_domains; d++)
+    {
+        if (m_domain_start[d] == m_domain_start[d + 1])
+            continue;
+
+        const int dx = d / (n * n), dy = (d / n) % n, dz = d % n;
+        colours[(dx & 1) << 2 | (dy & 1) << 1 | (dz & 1)].push_back(d);
+    }
 
-    if (fp == NULL)
-        throw std::runtime_error("The file could not be opened");
+    m_domain_products.resize(n_domains);
+    std::vector<unsigned int> domain_time(n_domains, 0);
 
-    Lexer lexer = Lexer();
-    Parser parser = Parser();
+    // Step the colours one after the other, and the domains of a colour in parallel
+    for (auto &&colour : colours)
+        m_pool->parallel_for(colour.size(), [&](size_t k)
+                             {
+            const int d = colour[k];
+            const int begin = m_domain_start[d], end = m_domain_start[d + 1];
+            for (int j = 0; j < end - begin; j++)
+            {
+                const int m = m_domain_molecules[m_inverse_direction ? end - j - 1 : begin + j];
 
-    parser.parse(lexer.lex_all(fp), m_reactions, m_instructions);
+                if (__move_molecule(m, m_domain_products[d]))
+                    domain_time[d] += 1;
+            } });
 
-    // Store the names of the molecules
-    for (int i = 0; i < lexer.m_HASH_SIZE; i++)
-        if (lexer.m_table[i] != NULL)
-            m_names[i] = std::string(lexer.m_table[i]);
+    // Gather the results in the order of the domains
+    for (size_t d = 0; d < n_domains; d++)
+    {
+        m_time += domain_time[d];
+        products.insert(products.end(), m_domain_products[d].begin(), m_domain_products[d].end());
+        m_domain_products[d].clear();
+    }
+}
 
-    fclose(fp);
+// ========================
+// CONSTRUCTORS
+Simulation::Simulation(const Simulation &other)
+{
+    *this = other;
 }
 
 // ========================
@@ -357,15 +406,168 @@ Simulation &Simulation::operator=(const Simulation &other)
 {
     if (this != &other)
     {
-        m_instructions = other.m_instructions;
+        m_model = other.m_model;
+        m_overrides = other.m_overrides;
         m_reactions = other.m_reactions;
-        m_start_positions = other.m_start_positions;
+        m_packing = other.m_packing;
         m_molecules = other.m_molecules;
-        m_ident_molecules = other.m_ident_molecules;
+        m_species = other.m_species;
+        m_counts = other.m_counts;
         max_diameter = other.max_diameter;
         m_inverse_direction = other.m_inverse_direction;
-        m_names = other.m_names;
-        m_map_instructions = other.m_map_instructions;
+        m_grid = other.m_grid;
+
+        // A pool runs one loop at a time, so each copy has its own pool
+        if (!other.m_pool)
+            m_pool.reset();
+        else if (!m_pool || m_pool == other.m_pool || m_pool->size() != other.m_pool->size())
+            m_pool = std::make_shared<ThreadPool>(other.m_pool->size());
+
+        m_philox = other.m_philox;
+        m_seed = other.m_seed;
+        m_tick = other.m_tick;
+        m_time = other.m_time;
     }
     return *this;
-}
\ No newline at end of file
+}
+// ========================
+// CHECKPOINT METHODS
+uint64_t Simulation::__fingerprint() const
+{
+    // FNV-1a over the parameters which drive the simulation: the species and the reactions
+    uint64_t h = 14695981039346656037ull;
+
+    auto mix = [&h](const void *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+            h = (h ^ static_cast<const unsigned char *>(data)[i]) * 1099511628211ull;
+    };
+
+    for (auto &&s : m_species)
+    {
+        mix(&s.diameter, sizeof(s.diameter));
+        mix(&s.speed, sizeof(s.speed));
+    }
+
+    for (auto &&r : m_reactions)
+    {
+        const int32_t ids[] = {r.ident, r.substrate, r.product};
+        const float probabilities[] = {r.p1, r.p2, r.p3};
+        mix(ids, sizeof(ids));
+        mix(probabilities, sizeof(probabilities));
+    }
+
+    return h;
+}
+
+void Simulation::save_state(std::vector<char> &buffer) const
+{
+    const size_t n = m_molecules.size();
+    buffer.clear();
+    buffer.reserve(64 + m_counts.size() * sizeof(uint32_t) + n * (5 * sizeof(float) + 2 * sizeof(int32_t) + 1));
+
+    auto put = [&buffer](const void *data, size_t size)
+    {
+        buffer.insert(buffer.end(), static_cast<const char *>(data), static_cast<const char *>(data) + size);
+    };
+
+    const uint32_t header[] = {m_STATE_VERSION, uint32_t(m_species.size()), uint32_t(m_reactions.size())};
+    const uint32_t clock[] = {m_tick, m_inverse_direction};
+    const uint64_t time = m_time;
+    const uint64_t n_molecules = n;
+    const uint64_t fingerprint = __fingerprint();
+
+    put("TERC", 4);
+    put(header, sizeof(header));
+    put(&fingerprint, sizeof(fingerprint));
+    put(&m_seed, sizeof(m_seed));
+    put(clock, sizeof(clock));
+    put(&time, sizeof(time));
+    put(&n_molecules, sizeof(n_molecules));
+    put(m_counts.data(), m_counts.size() * sizeof(uint32_t));
+
+    put(m_molecules.m_x.data(), n * sizeof(float));
+    put(m_molecules.m_y.data(), n * sizeof(float));
+    put(m_molecules.m_z.data(), n * sizeof(float));
+    put(m_molecules.m_diameter.data(), n * sizeof(float));
+    put(m_molecules.m_speed.data(), n * sizeof(float));
+    put(m_molecules.m_species.data(), n * sizeof(int32_t));
+    put(m_molecules.m_reaction.data(), n * sizeof(int32_t));
+    put(m_molecules.m_flags.data(), n);
+}
+
+void Simulation::load_state(const char *data, size_t size)
+{
+    const char *cursor = data;
+    const char *end = data + size;
+
+    auto get = [&cursor, end](void *out, size_t bytes)
+    {
+        if (size_t(end - cursor) < bytes)
+            throw std::runtime_error("The checkpoint is truncated");
+
+        memcpy(out, cursor, bytes);
+        cursor += bytes;
+    };
+
+    char magic[4];
+    uint32_t header[3], clock[2];
+    uint64_t fingerprint, seed, time, n_molecules;
+
+    get(magic, sizeof(magic));
+    if (memcmp(magic, "TERC", 4) != 0)
+        throw std::runtime_error("The file is not a checkpoint");
+
+    get(header, sizeof(header));
+    if (header[0] != m_STATE_VERSION)
+        throw std::runtime_error("The checkpoint has the version " + std::to_string(header[0]) +
+                                 ", and this program reads the version " + std::to_string(m_STATE_VERSION));
+
+    get(&fingerprint, sizeof(fingerprint));
+    if (header[1] != m_species.size() || header[2] != m_reactions.size() || fingerprint != __fingerprint())
+        throw std::runtime_error("The checkpoint does not match the model");
+
+    get(&seed, sizeof(seed));
+    get(clock, sizeof(clock));
+    get(&time, sizeof(time));
+    get(&n_molecules, sizeof(n_molecules));
+
+    // The size of the rest of the state is known, so it is checked before the molecules are resized
+    const size_t n = n_molecules;
+    if (size_t(end - cursor) != m_counts.size() * sizeof(uint32_t) + n * (5 * sizeof(float) + 2 * sizeof(int32_t) + 1))
+        throw std::runtime_error("The checkpoint is truncated");
+
+    m_counts.assign(m_species.size(), 0);
+    get(m_counts.data(), m_counts.size() * sizeof(uint32_t));
+
+    m_molecules = MoleculeStore();
+    m_molecules.m_x.resize(n);
+    m_molecules.m_y.resize(n);
+    m_molecules.m_z.resize(n);
+    m_molecules.m_diameter.resize(n);
+    m_molecules.m_speed.resize(n);
+    m_molecules.m_species.resize(n);
+    m_molecules.m_reaction.resize(n);
+    m_molecules.m_flags.resize(n);
+
+    get(m_molecules.m_x.data(), n * sizeof(float));
+    get(m_molecules.m_y.data(), n * sizeof(float));
+    get(m_molecules.m_z.data(), n * sizeof(float));
+    get(m_molecules.m_diameter.data(), n * sizeof(float));
+    get(m_molecules.m_speed.data(), n * sizeof(float));
+    get(m_molecules.m_species.data(), n * sizeof(int32_t));
+    get(m_molecules.m_reaction.data(), n * sizeof(int32_t));
+    get(m_molecules.m_flags.data(), n);
+
+    for (size_t i = 0; i < n; i++)
+        if (m_molecules.m_species[i] < 0 || m_molecules.m_species[i] >= int(m_species.size()) ||
+            m_molecules.m_reaction[i] < -1 || m_molecules.m_reaction[i] >= int(m_reactions.size()))
+            throw std::runtime_error("The checkpoint does not match the model");
+
+    // The random numbers of the next ticks only depend on the seed and the tick
+    m_seed = seed;
+    m_philox = Philox(m_seed);
+    m_tick = clock[0];
+    m_inverse_direction = clock[1] != 0;
+    m_time = time;
+}
@@ -0,0 +1,126 @@
+#include "../include/snapshot.hpp"
+#include <algorithm>
+#include <cmath>
+
+// ========================
+// SNAPSHOT
+void Snapshot::capture(const Simulation &simulation)
+{
+    const MoleculeStore &molecules = simulation.m_molecules;
+    const size_t n = molecules.size();
+    const int n_species = std::max<size_t>(1, simulation.m_species.size());
+
+    // The grid covers the vesicle, with fewer cells when there are many species
+    m_cells = std::max(1, std::min(m_CELLS, int(std::cbrt(double(m_MAX_BUCKETS / n_species)))));
+    m_cell_size = simulation.vesicle_diameter / m_cells;
+    m_origin = -simulation.vesicle_diameter / 2;
+
+    auto axis = [this](float v)
+    {
+        return std::max(0, std::min(m_cells - 1, int(std::floor((v - m_origin) / m_cell_size))));
+    };
+
+    // Count the molecules of each bucket, then sort them by bucket, keeping their order inside each bucket
+    m_keys.resize(n);
+    m_key_start.assign(m_cells * m_cells * m_cells * n_species + 1, 0);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const int cell = (axis(molecules.m_x[i]) * m_cells + axis(molecules.m_y[i])) * m_cells + axis(molecules.m_z[i]);
+        m_keys[i] = cell * n_species + molecules.m_species[i];
+        m_key_start[m_keys[i] + 1]++;
+    }
+
+    for (size_t k = 1; k < m_key_start.size(); k++)
+        m_key_start[k] += m_key_start[k - 1];
+
+    m_x.resize(n);
+    m_y.resize(n);
+    m_z.resize(n);
+    m_diameter.resize(n);
+    m_species.resize(n);
+
+    m_buckets.clear();
+    for (size_t k = 0; k + 1 < m_key_start.size(); k++)
+        if (m_key_start[k + 1] > m_key_start[k])
+            m_buckets.push_back({int(k / n_species), int(k % n_species), m_key_start[k], m_key_start[k + 1] - m_key_start[k], 0, 0, 0});
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const unsigned int k = m_key_start[m_keys[i]]++;
+
+        m_x[k] = molecules.m_x[i];
+        m_y[k] = molecules.m_y[i];
+        m_z[k] = molecules.m_z[i];
+        m_diameter[k] = molecules.m_diameter[i];
+        m_species[k] = molecules.m_species[i];
+    }
+
+    for (auto &&bucket : m_buckets)
+    {
+        double x = 0, y = 0, z = 0;
+        for (unsigned int i = bucket.start; i < bucket.start + bucket.count; i++)
+        {
+            x += m_x[i];
+            y += m_y[i];
+            z += m_z[i];
+        }
+
+        bucket.x = x / bucket.count;
+        bucket.y = y / bucket.count;
+        bucket.z = z / bucket.count;
+    }
+
+    m_counts.assign(simulation.m_counts.begin(), simulation.m_counts.end());
+
+    m_tick = simulation.m_tick;
+    m_time = simulation.m_time;
+}
+
+size_t Snapshot::size() const
+{
+    return m_x.size();
+}
+
+void Snapshot::cell_bounds(int cell, float low[3], float high[3]) const
+{
+    const int c[3] = {cell / (m_cells * m_cells), cell / m_cells % m_cells, cell % m_cells};
+
+    for (int a = 0; a < 3; a++)
+    {
+        low[a] = m_origin + c[a] * m_cell_size;
+        high[a] = low[a] + m_cell_size;
+    }
+}
+
+// ========================
+// SNAPSHOT BUFFER
+Snapshot &SnapshotBuffer::back()
+{
+    return m_snapshots[m_back];
+}
+
+void SnapshotBuffer::publish()
+{
+    // The release makes the content of the back snapshot visible to the reader which acquires it
+    m_back = m_middle.exchange(m_back | m_FRESH, std::memory_order_acq_rel) & ~m_FRESH;
+}
+
+bool SnapshotBuffer::consumed() const
+{
+    return !(m_middle.load(std::memory_order_relaxed) & m_FRESH);
+}
+
+bool SnapshotBuffer::acquire()
+{
+    if (consumed())
+        return false;
+
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~m_FRESH;
+    return true;
+}
+
+const Snapshot &SnapshotBuffer::front() const
+{
+    return m_snapshots[m_front];
+}
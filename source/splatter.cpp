@@ -0,0 +1,164 @@
+#include "../include/splatter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// CONSTRUCTORS
+Splatter::Splatter(int width, int height, size_t n_species) : m_width(width), m_height(height)
+{
+    for (size_t s = 0; s < n_species; s++)
+        m_colors.push_back(palette(s, n_species));
+}
+
+// ========================
+// METHODS
+void Splatter::render(const Snapshot &snapshot, std::vector<unsigned char> &image)
+{
+    __init_camera();
+
+    image.assign(size_t(m_width) * m_height * 3, m_BACKGROUND);
+    m_depth.assign(size_t(m_width) * m_height, std::numeric_limits<float>::infinity());
+
+    __draw_molecules(snapshot, image);
+    __draw_vesicle(image);
+}
+
+std::tuple<float, float, float> Splatter::palette(size_t species, size_t n_species)
+{
+    // The black corner of the lattice is left out, since it is not seen on the background
+    const int per_direction = std::max(2, int(std::ceil(std::cbrt(double(n_species + 1)) - 1e-9)));
+    const int index = species + 1;
+
+    const int r = index / (per_direction * per_direction);
+    const int g = index / per_direction % per_direction;
+    const int b = index % per_direction;
+
+    const float step = 1.f / (per_direction - 1);
+    return {r * step, g * step, b * step};
+}
+
+// ========================
+// PRIVATE METHODS
+void Splatter::__init_camera()
+{
+    // The rotation of the view: first around the x axis, then around the y axis
+    const float ax = m_rotate_x * M_PI / 180, ay = m_rotate_y * M_PI / 180;
+    const float cx = std::cos(ax), sx = std::sin(ax), cy = std::cos(ay), sy = std::sin(ay);
+
+    const float rotation[9] = {cy, sy * sx, sy * cx,
+                               0, cx, -sx,
+                               -sy, cy * sx, cy * cx};
+    std::copy(rotation, rotation + 9, m_rotation);
+
+    // The size of an object of width 1 at a distance of 1, in pixels
+    m_focal = m_height / (2 * std::tan(45.0 / 2 * M_PI / 180));
+}
+
+bool Splatter::__project(float x, float y, float z, float screen[3]) const
+{
+    const float ex = m_rotation[0] * x + m_rotation[1] * y + m_rotation[2] * z;
+    const float ey = m_rotation[3] * x + m_rotation[4] * y + m_rotation[5] * z;
+    const float distance = m_camera_distance - (m_rotation[6] * x + m_rotation[7] * y + m_rotation[8] * z);
+
+    // The near plane of the view
+    if (distance < 1)
+        return false;
+
+    screen[0] = m_width / 2.f + m_focal * ex / distance;
+    screen[1] = m_height / 2.f - m_focal * ey / distance;
+    screen[2] = distance;
+    return true;
+}
+
+void Splatter::__draw_molecules(const Snapshot &snapshot, std::vector<unsigned char> &image)
+{
+    for (size_t i = 0; i < snapshot.size(); i++)
+    {
+        float screen[3];
+        if (!__project(snapshot.m_x[i], snapshot.m_y[i], snapshot.m_z[i], screen))
+            continue;
+
+        const float radius = snapshot.m_diameter[i] / 2;
+        const float pixels = m_focal * radius / screen[2];
+        const std::tuple<float, float, float> &color = m_colors[snapshot.m_species[i]];
+
+        // The pixels covered by the disc, at least the one of its center
+        const int x0 = std::max(0, int(std::floor(screen[0] - pixels)));
+        const int x1 = std::min(m_width - 1, int(std::floor(screen[0] + pixels)));
+        const int y0 = std::max(0, int(std::floor(screen[1] - pixels)));
+        const int y1 = std::min(m_height - 1, int(std::floor(screen[1] + pixels)));
+
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++)
+            {
+                const float dx = (x + 0.5f - screen[0]) / std::max(pixels, 0.5f);
+                const float dy = (y + 0.5f - screen[1]) / std::max(pixels, 0.5f);
+                const float r2 = dx * dx + dy * dy;
+
+                if (r2 > 1)
+                    continue;
+
+                // The front of the sphere at this pixel
+                const float bulge = std::sqrt(1 - r2);
+                const float depth = screen[2] - radius * bulge;
+                const size_t p = size_t(y) * m_width + x;
+
+                if (depth >= m_depth[p])
+                    continue;
+
+                const float shade = 0.4f + 0.6f * bulge;
+                m_depth[p] = depth;
+                image[3 * p] = std::lround(255 * shade * std::get<0>(color));
+                image[3 * p + 1] = std::lround(255 * shade * std::get<1>(color));
+                image[3 * p + 2] = std::lround(255 * shade * std::get<2>(color));
+            }
+    }
+}
+
+void Splatter::__draw_vesicle(std::vector<unsigned char> &image) const
+{
+    // The points of the wire sphere, around the z axis as with glutWireSphere
+    auto point = [this](int slice, int stack, float screen[3])
+    {
+        const double phi = 2 * M_PI * slice / m_SLICES, theta = M_PI * stack / m_STACKS;
+        return __project(m_vesicle_radius * std::sin(theta) * std::cos(phi), m_vesicle_radius * std::sin(theta) * std::sin(phi),
+                         m_vesicle_radius * std::cos(theta), screen);
+    };
+
+    float from[3], to[3];
+
+    // The circles of latitude
+    for (int stack = 1; stack < m_STACKS; stack++)
+        for (int slice = 0; slice < m_SLICES; slice++)
+            if (point(slice, stack, from) && point(slice + 1, stack, to))
+                __blend_line(from, to, image);
+
+    // The meridians
+    for (int slice = 0; slice < m_SLICES; slice++)
+        for (int stack = 0; stack < m_STACKS; stack++)
+            if (point(slice, stack, from) && point(slice, stack + 1, to))
+                __blend_line(from, to, image);
+}
+
+void Splatter::__blend_line(const float from[3], const float to[3], std::vector<unsigned char> &image) const
+{
+    // One pixel by step along the longest direction. The end is left to the next line, so no pixel is blended twice
+    const int steps = std::max(1, int(std::ceil(std::max(std::fabs(to[0] - from[0]), std::fabs(to[1] - from[1])))));
+
+    for (int k = 0; k < steps; k++)
+    {
+        const float t = float(k) / steps;
+        const int x = std::floor(from[0] + t * (to[0] - from[0]));
+        const int y = std::floor(from[1] + t * (to[1] - from[1]));
+
+        if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+            continue;
+
+        const size_t p = size_t(y) * m_width + x;
+        if (from[2] + t * (to[2] - from[2]) >= m_depth[p])
+            continue;
+
+        for (int c = 0; c < 3; c++)
+            image[3 * p + c] = std::lround(image[3 * p + c] + m_VESICLE_ALPHA * (255 - image[3 * p + c]));
+    }
+}
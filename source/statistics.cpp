@@ -0,0 +1,107 @@
+#include "../include/statistics.hpp"
+#include <algorithm>
+#include <cmath>
+
+// ========================
+// RUNNING STATS
+void RunningStats::add(double x)
+{
+    m_count++;
+
+    const double delta = x - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (x - m_mean);
+}
+
+double RunningStats::variance() const
+{
+    return m_count > 1 ? m_m2 / (m_count - 1) : 0;
+}
+
+// ========================
+// P2 QUANTILE
+P2Quantile::P2Quantile(double p) : m_p(p)
+{
+    const double desired[5] = {1, 1 + 2 * p, 1 + 4 * p, 3 + 2 * p, 5};
+    const double increments[5] = {0, p / 2, p, (1 + p) / 2, 1};
+
+    std::copy(desired, desired + 5, m_desired);
+    std::copy(increments, increments + 5, m_increments);
+}
+
+void P2Quantile::add(double x)
+{
+    // The 5 first numbers are the initial heights of the markers
+    if (m_count < 5)
+    {
+        m_heights[m_count++] = x;
+
+        if (m_count == 5)
+            std::sort(m_heights, m_heights + 5);
+
+        return;
+    }
+
+    // Find the cell of the number, and extend the extreme markers if needed
+    int k;
+    if (x < m_heights[0])
+    {
+        m_heights[0] = x;
+        k = 0;
+    }
+    else if (x >= m_heights[4])
+    {
+        m_heights[4] = x;
+        k = 3;
+    }
+    else
+        for (k = 0; k < 3 && x >= m_heights[k + 1]; k++)
+            ;
+
+    for (int i = k + 1; i < 5; i++)
+        m_positions[i] += 1;
+
+    for (int i = 0; i < 5; i++)
+        m_desired[i] += m_increments[i];
+
+    // Move the middle markers which are too far from their desired position
+    for (int i = 1; i < 4; i++)
+    {
+        const double d = m_desired[i] - m_positions[i];
+
+        if ((d >= 1 && m_positions[i + 1] - m_positions[i] > 1) || (d <= -1 && m_positions[i - 1] - m_positions[i] < -1))
+        {
+            const int sign = d > 0 ? 1 : -1;
+
+            // Parabolic prediction of the height, or linear if it is not between the neighbours
+            const double parabolic = m_heights[i] + sign / (m_positions[i + 1] - m_positions[i - 1]) *
+                                                        ((m_positions[i] - m_positions[i - 1] + sign) * (m_heights[i + 1] - m_heights[i]) / (m_positions[i + 1] - m_positions[i]) +
+                                                         (m_positions[i + 1] - m_positions[i] - sign) * (m_heights[i] - m_heights[i - 1]) / (m_positions[i] - m_positions[i - 1]));
+
+            if (m_heights[i - 1] < parabolic && parabolic < m_heights[i + 1])
+                m_heights[i] = parabolic;
+            else
+                m_heights[i] += sign * (m_heights[i + sign] - m_heights[i]) / (m_positions[i + sign] - m_positions[i]);
+
+            m_positions[i] += sign;
+        }
+    }
+
+    m_count++;
+}
+
+double P2Quantile::value() const
+{
+    if (m_count >= 5)
+        return m_heights[2];
+
+    if (m_count == 0)
+        return 0;
+
+    // With less than 5 numbers, take the quantile of the sorted numbers
+    double sorted[5];
+    std::copy(m_heights, m_heights + m_count, sorted);
+    std::sort(sorted, sorted + m_count);
+
+    return sorted[size_t(std::lround(m_p * (m_count - 1)))];
+}
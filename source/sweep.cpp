@@ -0,0 +1,248 @@
+#include "../include/sweep.hpp"
+#include "../include/random.hpp"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+// CONSTRUCTORS
+Sweep::Sweep(std::shared_ptr<const Model> model, std::function<std::unique_ptr<Engine>()> make_engine, unsigned long ticks)
+    : m_model(model), m_make_engine(make_engine), m_ticks(ticks)
+{
+}
+
+// ========================
+// PRIVATE METHODS
+void Sweep::__run_point(size_t point, uint64_t seed)
+{
+    std::unique_ptr<Engine> engine = m_make_engine();
+    engine->m_seed = mix_seed(seed + point);
+
+    for (size_t a = 0; a < m_axes.size(); a++)
+        engine->m_overrides.push_back({m_axes[a].parameter, m_axes[a].target, m_points[point][a]});
+
+    engine->init(m_model);
+
+    while (engine->m_tick < m_ticks)
+        engine->step();
+
+    // Each run writes its own line, so no lock is needed
+    m_results[point] = engine->m_counts;
+
+    std::call_once(m_names_once, [&]
+                   {
+        for (size_t s = 0; s < engine->m_species.size(); s++)
+            m_names.push_back(engine->species_name(s)); });
+}
+
+// ========================
+// METHODS
+void Sweep::read_file(const char *path, uint64_t seed)
+{
+    std::ifstream file(path);
+
+    if (!file)
+        throw std::runtime_error("The file " + std::string(path) + " could not be opened");
+
+    bool design = false;
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream words(line);
+        std::string keyword;
+
+        if (!(words >> keyword) || keyword[0] == '#')
+            continue;
+
+        if (keyword == "grid" || keyword == "lhs")
+        {
+            m_samples = 0;
+            if (keyword == "lhs" && !(words >> m_samples))
+                throw std::runtime_error("The number of samples of the Latin hypercube is missing");
+
+            design = true;
+            continue;
+        }
+
+        if (!design)
+            throw std::runtime_error("The sweep file must start with 'grid' or 'lhs <samples>'");
+
+        Axis axis;
+        std::string target;
+        words >> std::quoted(target);
+
+        // The reactions are given by their index, the species by their name
+        if (keyword == "kcat" || keyword == "mM")
+        {
+            axis.parameter = keyword == "kcat" ? KCAT : MM;
+            axis.target = atoi(target.c_str());
+
+            if (axis.target < 0 || axis.target >= int(m_model->m_reactions.size()))
+                throw std::runtime_error("The reaction " + target + " does not exist");
+        }
+
+        else if (keyword == "diametre" || keyword == "vitesse")
+        {
+            axis.parameter = keyword == "diametre" ? DIAMETER_OF : SPEED_OF;
+            axis.target = -1;
+
+            for (size_t id = 0; id < m_model->m_names.size(); id++)
+                if (m_model->m_names[id] == target)
+                    axis.target = id;
+
+            if (axis.target == -1)
+                throw std::runtime_error("The species " + target + " does not exist");
+        }
+
+        else
+            throw std::runtime_error("Unknown parameter " + keyword);
+
+        axis.label = keyword + "[" + target + "]";
+
+        float value;
+        while (words >> value)
+            axis.values.push_back(value);
+
+        if (m_samples > 0)
+        {
+            if (axis.values.size() != 2)
+                throw std::runtime_error("The range of " + axis.label + " must be 'min max'");
+
+            axis.min = axis.values[0];
+            axis.max = axis.values[1];
+        }
+
+        if (axis.values.empty())
+            throw std::runtime_error("The parameter " + axis.label + " has no value");
+
+        m_axes.push_back(axis);
+    }
+
+    // Make the points of the sweep
+    m_points.clear();
+
+    if (m_samples > 0)
+    {
+        // Latin hypercube: each axis is cut in as many strata as samples, and each stratum is used once
+        Xoshiro256 random(seed);
+        m_points.assign(m_samples, std::vector<float>(m_axes.size()));
+
+        for (size_t a = 0; a < m_axes.size(); a++)
+        {
+            std::vector<unsigned int> strata(m_samples);
+            std::iota(strata.begin(), strata.end(), 0);
+            std::shuffle(strata.begin(), strata.end(), random);
+
+            for (unsigned int p = 0; p < m_samples; p++)
+                m_points[p][a] = m_axes[a].min + (strata[p] + random.uniform()) / m_samples * (m_axes[a].max - m_axes[a].min);
+        }
+    }
+
+    else
+    {
+        // Full grid: every combination of the values, the last axis changing the fastest
+        size_t n_points = m_axes.empty() ? 0 : 1;
+        for (auto &&axis : m_axes)
+            n_points *= axis.values.size();
+
+        for (size_t p = 0; p < n_points; p++)
+        {
+            std::vector<float> point(m_axes.size());
+            size_t rest = p;
+
+            for (size_t a = m_axes.size(); a-- > 0;)
+            {
+                point[a] = m_axes[a].values[rest % m_axes[a].values.size()];
+                rest /= m_axes[a].values.size();
+            }
+
+            m_points.push_back(point);
+        }
+    }
+
+    m_results.assign(m_points.size(), {});
+}
+
+void Sweep::run(uint64_t seed, ThreadPool &pool)
+{
+    const unsigned int n_threads = pool.size();
+
+    // Deal the points to the queues of the threads
+    std::vector<std::deque<size_t>> queues(n_threads);
+    std::vector<std::mutex> locks(n_threads);
+
+    for (size_t p = 0; p < m_points.size(); p++)
+        queues[p % n_threads].push_back(p);
+
+    // Set when a run has failed, so the other threads stop taking points. The pool throws the error again
+    std::atomic<bool> failed{false};
+
+    pool.parallel_for(n_threads, [&](size_t t)
+                      {
+        while (!failed)
+        {
+            bool found = false;
+            size_t point = 0;
+
+            // Take the next point of the own queue, or steal the last point of another queue
+            for (unsigned int k = 0; k < n_threads && !found; k++)
+            {
+                const size_t q = (t + k) % n_threads;
+                std::lock_guard<std::mutex> lock(locks[q]);
+
+                if (queues[q].empty())
+                    continue;
+
+                if (k == 0)
+                {
+                    point = queues[q].front();
+                    queues[q].pop_front();
+                }
+                else
+                {
+                    point = queues[q].back();
+                    queues[q].pop_back();
+                }
+
+                found = true;
+            }
+
+            if (!found)
+                return;
+
+            try
+            {
+                __run_point(point, seed);
+            }
+            catch (...)
+            {
+                failed = true;
+                throw;
+            }
+        } });
+}
+
+void Sweep::write(FILE *fp) const
+{
+    fprintf(fp, "run");
+    for (auto &&axis : m_axes)
+        fprintf(fp, ",\"%s\"", axis.label.c_str());
+    for (auto &&name : m_names)
+        fprintf(fp, ",\"%s\"", name.c_str());
+    fprintf(fp, "\n");
+
+    for (size_t p = 0; p < m_points.size(); p++)
+    {
+        fprintf(fp, "%zu", p);
+        for (auto &&value : m_points[p])
+            fprintf(fp, ",%g", value);
+        for (auto &&count : m_results[p])
+            fprintf(fp, ",%u", count);
+        fprintf(fp, "\n");
+    }
+}
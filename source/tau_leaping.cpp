@@ -0,0 +1,350 @@
+#include "../include/tau_leaping.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+/**
+ * @brief Solve the linear system a * x = b with Gaussian elimination and partial pivoting
+ *
+ * @param a The matrix, n * n in row-major order, overwritten
+ * @param b The right-hand side, overwritten with the solution
+ */
+static void solve_linear(std::vector<double> &a, std::vector<double> &b)
+{
+    const size_t n = b.size();
+
+    for (size_t col = 0; col < n; col++)
+    {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; row++)
+            if (std::fabs(a[row * n + col]) > std::fabs(a[pivot * n + col]))
+                pivot = row;
+
+        if (pivot != col)
+        {
+            for (size_t k = 0; k < n; k++)
+                std::swap(a[col * n + k], a[pivot * n + k]);
+            std::swap(b[col], b[pivot]);
+        }
+
+        if (a[col * n + col] == 0)
+            continue;
+
+        for (size_t row = col + 1; row < n; row++)
+        {
+            const double factor = a[row * n + col] / a[col * n + col];
+            if (factor == 0)
+                continue;
+
+            for (size_t k = col; k < n; k++)
+                a[row * n + k] -= factor * a[col * n + k];
+            b[row] -= factor * b[col];
+        }
+    }
+
+    for (size_t col = n; col-- > 0;)
+    {
+        for (size_t k = col + 1; k < n; k++)
+            b[col] -= a[col * n + k] * b[k];
+
+        b[col] = a[col * n + col] != 0 ? b[col] / a[col * n + col] : 0;
+    }
+}
+
+// PRIVATE METHODS
+void TauLeaping::__quantities(std::vector<double> &quantities) const
+{
+    const size_t n_species = m_species.size();
+    quantities.resize(n_species + m_reactions.size());
+
+    for (size_t s = 0; s < n_species; s++)
+        quantities[s] = double(m_counts[s]) - m_bound_enzymes[s];
+
+    for (size_t r = 0; r < m_reactions.size(); r++)
+        quantities[n_species + r] = m_bound[r];
+}
+
+double TauLeaping::__rate_of(int channel, const std::vector<double> &quantities) const
+{
+    const std::vector<int> &reactants = m_reactants[channel];
+
+    // Es -> E + p, and Es -> E + s
+    if (reactants.size() == 1)
+        return m_constants[channel] * quantities[reactants[0]];
+
+    // E + s -> Es, for each pair of free molecules
+    if (reactants[0] == reactants[1])
+        return m_constants[channel] * quantities[reactants[0]] * (quantities[reactants[0]] - 1) / 2;
+
+    return m_constants[channel] * quantities[reactants[0]] * quantities[reactants[1]];
+}
+
+double TauLeaping::__select_tau(const std::vector<double> &quantities, const std::vector<double> &rates) const
+{
+    const size_t n_channels = rates.size();
+
+    // The channels left out of the choice of tau, in partial equilibrium with their reverse
+    std::vector<bool> excluded(n_channels, false);
+
+    if (m_implicit)
+        for (size_t c = 0; c < n_channels; c += m_CHANNELS)
+        {
+            const double binding = rates[c], release = rates[c + 2];
+
+            if (binding > 0 && release > 0 && std::fabs(binding - release) <= m_EQUILIBRIUM * std::min(binding, release))
+                excluded[c] = excluded[c + 2] = true;
+        }
+
+    // The expected change of each quantity over a tick, and its variance
+    std::vector<double> mean(quantities.size(), 0), variance(quantities.size(), 0);
+
+    for (size_t c = 0; c < n_channels; c++)
+    {
+        if (excluded[c] || rates[c] == 0)
+            continue;
+
+        for (int k = m_changes_start[c]; k < m_changes_start[c + 1]; k++)
+        {
+            mean[m_changes[k].first] += m_changes[k].second * rates[c];
+            variance[m_changes[k].first] += m_changes[k].second * m_changes[k].second * rates[c];
+        }
+    }
+
+    double tau = std::numeric_limits<double>::infinity();
+
+    for (size_t q = 0; q < quantities.size(); q++)
+    {
+        if (m_orders[q] == 0)
+            continue;
+
+        // A molecule which can react with another molecule of its species has a order of 2 + 1 / (x - 1)
+        double order = m_orders[q];
+        if (order < 0)
+            order = quantities[q] > 1 ? 2 + 1 / (quantities[q] - 1) : 2;
+
+        const double bound = std::max(m_epsilon * quantities[q] / order, 1.);
+
+        if (mean[q] != 0)
+            tau = std::min(tau, bound / std::fabs(mean[q]));
+        if (variance[q] != 0)
+            tau = std::min(tau, bound * bound / variance[q]);
+    }
+
+    return tau;
+}
+
+void TauLeaping::__solve_implicit(const std::vector<double> &quantities, const std::vector<double> &rates,
+                                  const std::vector<double> &firings, double tau, std::vector<double> &solution) const
+{
+    const size_t n = quantities.size();
+    const size_t n_channels = rates.size();
+
+    // The part of the solution which does not depend on it: x + sum(v * (P - a(x) * tau))
+    std::vector<double> constant = quantities;
+    for (size_t c = 0; c < n_channels; c++)
+        for (int k = m_changes_start[c]; k < m_changes_start[c + 1]; k++)
+            constant[m_changes[k].first] += m_changes[k].second * (firings[c] - rates[c] * tau);
+
+    solution = quantities;
+
+    std::vector<double> jacobian(n * n), residual(n);
+
+    for (int iteration = 0; iteration < 20; iteration++)
+    {
+        // F(y) = y - constant - tau * sum(v * a(y)), and its jacobian I - tau * sum(v * grad(a(y)))
+        std::fill(jacobian.begin(), jacobian.end(), 0);
+        for (size_t q = 0; q < n; q++)
+        {
+            residual[q] = constant[q] - solution[q];
+            jacobian[q * n + q] = 1;
+        }
+
+        for (size_t c = 0; c < n_channels; c++)
+        {
+            const std::vector<int> &reactants = m_reactants[c];
+            const double rate = __rate_of(c, solution);
+
+            // The derivatives of the rate with respect to its reactants
+            double gradient[2] = {m_constants[c], 0};
+
+            if (reactants.size() == 2 && reactants[0] == reactants[1])
+                gradient[0] = m_constants[c] * (2 * solution[reactants[0]] - 1) / 2;
+
+            else if (reactants.size() == 2)
+            {
+                gradient[0] = m_constants[c] * solution[reactants[1]];
+                gradient[1] = m_constants[c] * solution[reactants[0]];
+            }
+
+            for (int k = m_changes_start[c]; k < m_changes_start[c + 1]; k++)
+            {
+                const int q = m_changes[k].first;
+                const int change = m_changes[k].second;
+
+                residual[q] += tau * change * rate;
+                jacobian[q * n + reactants[0]] -= tau * change * gradient[0];
+                if (reactants.size() == 2 && reactants[0] != reactants[1])
+                    jacobian[q * n + reactants[1]] -= tau * change * gradient[1];
+            }
+        }
+
+        solve_linear(jacobian, residual);
+
+        double change = 0;
+        for (size_t q = 0; q < n; q++)
+        {
+            solution[q] += residual[q];
+            change = std::max(change, std::fabs(residual[q]));
+        }
+
+        if (change < 1e-6)
+            break;
+    }
+}
+
+bool TauLeaping::__leap(const std::vector<double> &quantities, const std::vector<double> &rates, double tau)
+{
+    const size_t n_channels = rates.size();
+    std::vector<double> firings(n_channels, 0);
+
+    for (size_t c = 0; c < n_channels; c++)
+        if (rates[c] > 0)
+            firings[c] = std::poisson_distribution<long long>(rates[c] * tau)(m_random);
+
+    // The implicit mode replaces the expected firings at the start of the leap by those at the end
+    if (m_implicit)
+    {
+        std::vector<double> solution;
+        __solve_implicit(quantities, rates, firings, tau, solution);
+
+        for (size_t c = 0; c < n_channels; c++)
+            firings[c] = std::max(0., std::round(firings[c] - rates[c] * tau + __rate_of(c, solution) * tau));
+    }
+
+    // Reject the leap if a quantity would become negative
+    std::vector<double> after = quantities;
+    for (size_t c = 0; c < n_channels; c++)
+        for (int k = m_changes_start[c]; k < m_changes_start[c + 1]; k++)
+            after[m_changes[k].first] += m_changes[k].second * firings[c];
+
+    for (auto &&q : after)
+        if (q < 0)
+            return false;
+
+    for (size_t c = 0; c < n_channels; c++)
+        if (firings[c] > 0)
+        {
+            __fire(c, firings[c]);
+            m_time += firings[c];
+        }
+
+    m_leaps += 1;
+    return true;
+}
+
+// ========================
+// INITIALIZATION METHODS
+void TauLeaping::init(std::shared_ptr<const Model> model)
+{
+    Gillespie::init(model);
+    init_stoichiometry();
+}
+
+void TauLeaping::init_stoichiometry()
+{
+    const int n_species = m_species.size();
+
+    m_changes_start.assign(1, 0);
+    m_changes.clear();
+    m_reactants.assign(m_constants.size(), {});
+    m_orders.assign(n_species + m_reactions.size(), 0);
+
+    for (size_t i = 0; i < m_reactions.size(); i++)
+    {
+        const react &r = m_reactions[i];
+        const int bound = n_species + i;
+        const int c = i * m_CHANNELS;
+
+        // E + s -> Es
+        m_reactants[c] = {r.ident, r.substrate};
+        m_changes.insert(m_changes.end(), {{r.ident, -1}, {r.substrate, -1}, {bound, 1}});
+        m_changes_start.push_back(m_changes.size());
+
+        // Es -> E + p
+        m_reactants[c + 1] = {bound};
+        m_changes.insert(m_changes.end(), {{bound, -1}, {r.ident, 1}, {r.product, 1}});
+        m_changes_start.push_back(m_changes.size());
+
+        // Es -> E + s
+        m_reactants[c + 2] = {bound};
+        m_changes.insert(m_changes.end(), {{bound, -1}, {r.ident, 1}, {r.substrate, 1}});
+        m_changes_start.push_back(m_changes.size());
+
+        // The highest order of the channels reading each quantity, -1 for a pair of the same species
+        if (m_constants[c] > 0)
+        {
+            if (r.ident == r.substrate)
+                m_orders[r.ident] = -1;
+
+            else
+            {
+                if (m_orders[r.ident] != -1)
+                    m_orders[r.ident] = 2;
+                if (m_orders[r.substrate] != -1)
+                    m_orders[r.substrate] = 2;
+            }
+        }
+
+        m_orders[bound] = 1;
+    }
+}
+
+// ========================
+// STEPPING METHODS
+void TauLeaping::step()
+{
+    const double end = m_tick + 1;
+
+    std::vector<double> quantities, rates(m_constants.size());
+
+    while (m_clock < end)
+    {
+        __quantities(quantities);
+
+        double total = 0;
+        for (size_t c = 0; c < rates.size(); c++)
+        {
+            rates[c] = __rate_of(c, quantities);
+            total += rates[c];
+        }
+
+        // Nothing can happen anymore
+        if (total <= 0)
+            break;
+
+        double tau = __select_tau(quantities, rates);
+
+        // When only a few reactions would fire in the leap, fire them one by one with the exact SSA.
+        // The times of the channels are drawn again, which is exact since the waiting times have no memory
+        if (tau * total < m_SSA_THRESHOLD)
+        {
+            init_heap();
+
+            if (__run(end, m_SSA_REACTIONS) < unsigned(m_SSA_REACTIONS))
+                break;
+
+            continue;
+        }
+
+        tau = std::min(tau, end - m_clock);
+
+        // Try again with half the leap while it makes a count negative
+        while (!__leap(quantities, rates, tau))
+            tau /= 2;
+
+        m_clock += tau;
+    }
+
+    m_clock = end;
+    m_tick += 1;
+}
@@ -0,0 +1,120 @@
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+// CONSTRUCTORS
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 1; i < threads; i++)
+        m_workers.emplace_back(&ThreadPool::__work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+
+    for (auto &&worker : m_workers)
+        worker.join();
+}
+
+// ========================
+// METHODS
+unsigned int ThreadPool::size() const
+{
+    return m_workers.size() + 1;
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)> &task)
+{
+    if (count == 0)
+        return;
+
+    // Without workers, or with a single task, run the loop on the calling thread
+    if (m_workers.empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; i++)
+            task(i);
+
+        return;
+    }
+
+    // Publish the loop and wake up the workers
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_next = 0;
+        m_active = m_workers.size();
+        m_generation++;
+    }
+
+    m_wake.notify_all();
+
+    // Take part in the loop, then wait for the workers
+    __run_tasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]
+                { return m_active == 0; });
+
+    m_task = nullptr;
+
+    if (m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+}
+
+// ========================
+// PRIVATE METHODS
+void ThreadPool::__work()
+{
+    unsigned int generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, generation]
+                        { return m_stop || m_generation != generation; });
+
+            if (m_stop)
+                return;
+
+            generation = m_generation;
+        }
+
+        __run_tasks();
+
+        // The last worker to finish wakes up the calling thread
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_active == 0)
+            m_done.notify_one();
+    }
+}
+
+void ThreadPool::__run_tasks()
+{
+    for (size_t i = m_next++; i < m_count; i = m_next++)
+    {
+        try
+        {
+            (*m_task)(i);
+        }
+        catch (...)
+        {
+            // Keep the first exception, and skip the tasks not started yet
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error)
+                m_error = std::current_exception();
+
+            m_next = m_count;
+        }
+    }
+}
@@ -0,0 +1,473 @@
+#include "../include/video.hpp"
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief Update the CRC-32 of PNG with some bytes
+ *
+ * @param crc The CRC of the previous bytes
+ * @param data The bytes
+ * @param size The number of bytes
+ * @return uint32_t The CRC
+ */
+static uint32_t crc32(uint32_t crc, const unsigned char *data, size_t size)
+{
+    static const std::vector<uint32_t> table = []
+    {
+        std::vector<uint32_t> t(256);
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+/**
+ * @brief Append a number to a buffer, in big-endian order as in PNG and zlib
+ *
+ * @param out The buffer
+ * @param value The number
+ */
+static void put_be32(std::vector<unsigned char> &out, uint32_t value)
+{
+    out.insert(out.end(), {(unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value});
+}
+
+/**
+ * @brief The BitWriter struct appends the bits of a deflate stream to a buffer, from the least significant bit.
+ */
+struct BitWriter
+{
+    std::vector<unsigned char> &out;
+    uint64_t bits = 0;
+    int count = 0;
+
+    void put(uint32_t value, int n)
+    {
+        bits |= uint64_t(value) << count;
+        count += n;
+
+        while (count >= 8)
+        {
+            out.push_back(bits & 0xff);
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    // The Huffman codes are stored from their most significant bit
+    void put_code(uint32_t code, int n)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < n; i++)
+            reversed |= ((code >> i) & 1) << (n - 1 - i);
+
+        put(reversed, n);
+    }
+
+    // A literal, a length or the end of the block, with the fixed Huffman codes
+    void put_symbol(int symbol)
+    {
+        if (symbol < 144)
+            put_code(0x30 + symbol, 8);
+        else if (symbol < 256)
+            put_code(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            put_code(symbol - 256, 7);
+        else
+            put_code(0xc0 + symbol - 280, 8);
+    }
+
+    void flush()
+    {
+        if (count > 0)
+            out.push_back(bits & 0xff);
+
+        bits = 0;
+        count = 0;
+    }
+};
+
+/**
+ * @brief Compress bytes to a zlib stream, with a single deflate block of fixed Huffman codes.
+ * The only matches are the runs of a repeated byte, at a distance of 1: with the Sub filter of PNG,
+ * the background and the inside of the molecules are long runs of zeros
+ *
+ * @param data The bytes
+ * @param out The buffer, to which the stream is appended
+ */
+static void deflate_runs(const std::vector<unsigned char> &data, std::vector<unsigned char> &out)
+{
+    static const int base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const int extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+    // The header of zlib: deflate with a window of 32 KB, and the fastest level
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    BitWriter writer{out};
+    writer.put(1, 1); // The last block
+    writer.put(1, 2); // With the fixed codes
+
+    size_t i = 0;
+    while (i < data.size())
+    {
+        size_t run = 0;
+        if (i > 0)
+            while (run < 258 && i + run < data.size() && data[i + run] == data[i - 1])
+                run++;
+
+        if (run < 3)
+        {
+            writer.put_symbol(data[i]);
+            i++;
+            continue;
+        }
+
+        int code = 28;
+        while (base[code] > int(run))
+            code--;
+
+        writer.put_symbol(257 + code);
+        writer.put(run - base[code], extra[code]);
+        writer.put_code(0, 5); // The distance 1
+        i += run;
+    }
+
+    writer.put_symbol(256);
+    writer.flush();
+
+    // The Adler-32 checksum of the bytes
+    uint32_t a = 1, b = 0;
+    for (size_t k = 0; k < data.size(); k++)
+    {
+        a = (a + data[k]) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    put_be32(out, (b << 16) | a);
+}
+
+/**
+ * @brief Append a chunk to a PNG file
+ *
+ * @param out The buffer of the file
+ * @param type The type of the chunk
+ * @param data The data of the chunk
+ */
+static void put_chunk(std::vector<unsigned char> &out, const char *type, const std::vector<unsigned char> &data)
+{
+    put_be32(out, data.size());
+
+    const size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+
+    put_be32(out, crc32(0, out.data() + start, out.size() - start));
+}
+
+/**
+ * @brief Check that a path is a pattern of PNG files, which is safe to give to printf with the index of a frame:
+ * exactly one integer conversion like %d or %06d, and no other conversion than %%
+ *
+ * @param path The path
+ * @return true If the path is a pattern of PNG files
+ */
+static bool is_frame_pattern(const std::string &path)
+{
+    int conversions = 0;
+
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        if (path[i] != '%')
+            continue;
+
+        if (++i < path.size() && path[i] == '%')
+            continue;
+
+        // Flags and width, then the conversion
+        while (i < path.size() && (path[i] == '0' || path[i] == '-'))
+            i++;
+        while (i < path.size() && path[i] >= '0' && path[i] <= '9')
+            i++;
+
+        if (i == path.size() || (path[i] != 'd' && path[i] != 'i' && path[i] != 'u'))
+            return false;
+
+        conversions++;
+    }
+
+    return conversions == 1;
+}
+
+// CONSTRUCTORS
+VideoWriter::VideoWriter(const std::string &path, int width, int height, size_t n_species, int fps)
+    : m_splatter(width, height, n_species), m_fps(fps), m_path(path)
+{
+    if (width <= 0 || height <= 0)
+        throw std::runtime_error("The size of the video must be positive");
+
+    // Check everything before opening the output, so nothing is left open when the construction fails
+    const bool pipe = path.size() > 1 && path[0] == '|';
+    const bool y4m = path.size() > 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+
+    if (pipe || y4m || path == "-")
+        m_format = Y4M_STREAM;
+
+    else if (is_frame_pattern(path))
+        m_format = PNG_FRAMES;
+
+    else
+        throw std::runtime_error("The video " + path + " is neither a .y4m file, a pipe nor a pattern of PNG files like frames/%06d.png");
+
+    if (m_format == Y4M_STREAM)
+    {
+        if (width % 2 || height % 2)
+            throw std::runtime_error("The size of a YUV video must be even");
+
+        if (pipe)
+        {
+            m_pipe = true;
+            m_stream = popen(path.c_str() + 1, "w");
+        }
+
+        else
+            m_stream = path == "-" ? stdout : fopen(path.c_str(), "wb");
+
+        if (m_stream == NULL)
+            throw std::runtime_error("The video " + path + " could not be opened");
+
+        fprintf(m_stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, m_fps);
+    }
+
+    m_snapshots.resize(m_POOL_SIZE);
+    for (int s = m_POOL_SIZE - 1; s >= 0; s--)
+        m_free.push_back(s);
+
+    m_encoder = std::thread(&VideoWriter::__encode, this);
+}
+
+VideoWriter::~VideoWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception &)
+    {
+    }
+}
+
+// ========================
+// METHODS
+void VideoWriter::submit(const Simulation &simulation)
+{
+    int s;
+
+    // Take a free snapshot, and wait for the encoder if it is too far behind
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_freed.wait(lock, [this]
+                     { return !m_free.empty() || !m_error.empty(); });
+
+        if (!m_error.empty())
+            throw std::runtime_error(m_error);
+
+        s = m_free.back();
+        m_free.pop_back();
+    }
+
+    // The snapshot is only used by the simulation until it is queued
+    m_snapshots[s].capture(simulation);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(s);
+    }
+
+    m_wake.notify_one();
+}
+
+void VideoWriter::close()
+{
+    if (m_encoder.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_one();
+        m_encoder.join();
+    }
+
+    if (m_stream)
+    {
+        bool closed = true;
+
+        if (m_pipe)
+            closed = pclose(m_stream) == 0;
+        else if (m_stream == stdout)
+            closed = fflush(m_stream) == 0;
+        else
+            closed = fclose(m_stream) == 0;
+
+        m_stream = nullptr;
+
+        if (!closed && m_error.empty())
+            m_error = "The video " + m_path + " could not be written";
+    }
+
+    if (!m_error.empty())
+        throw std::runtime_error(m_error);
+}
+
+// ========================
+// PRIVATE METHODS
+void VideoWriter::__encode()
+{
+    for (;;)
+    {
+        int s;
+        bool failed;
+
+        // The encoder only stops once all the queued frames are written
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]
+                        { return m_stop || !m_queue.empty(); });
+
+            if (m_queue.empty())
+                return;
+
+            s = m_queue.front();
+            m_queue.pop_front();
+            failed = !m_error.empty();
+        }
+
+        // After an error, the frames are dropped
+        const std::string error = failed ? "" : __write_frame(m_snapshots[s]);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!error.empty())
+                m_error = error;
+
+            m_free.push_back(s);
+        }
+
+        m_freed.notify_one();
+    }
+}
+
+std::string VideoWriter::__write_frame(const Snapshot &snapshot)
+{
+    m_splatter.render(snapshot, m_image);
+
+    const std::string error = m_format == PNG_FRAMES ? __write_png() : __write_y4m();
+
+    if (error.empty())
+        m_frames += 1;
+
+    return error;
+}
+
+std::string VideoWriter::__write_png()
+{
+    const int width = m_splatter.m_width, height = m_splatter.m_height;
+    const size_t stride = size_t(width) * 3;
+
+    // Each row starts with its filter, Sub: each byte is stored as its difference with the same channel of the previous pixel
+    std::vector<unsigned char> filtered(height * (stride + 1));
+
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *row = m_image.data() + y * stride;
+        unsigned char *out = filtered.data() + y * (stride + 1);
+
+        out[0] = 1;
+        for (size_t i = 0; i < stride; i++)
+            out[1 + i] = i < 3 ? row[i] : row[i] - row[i - 3];
+    }
+
+    std::vector<unsigned char> header, compressed;
+    put_be32(header, width);
+    put_be32(header, height);
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 bits per channel, RGB, deflate, adaptive filters, no interlace
+
+    deflate_runs(filtered, compressed);
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    m_encoded.assign(signature, signature + 8);
+    put_chunk(m_encoded, "IHDR", header);
+    put_chunk(m_encoded, "IDAT", compressed);
+    put_chunk(m_encoded, "IEND", {});
+
+    // The name of the file, from the pattern and the index of the frame. The pattern was checked by the constructor
+    std::vector<char> name(m_path.size() + 32);
+    snprintf(name.data(), name.size(), m_path.c_str(), m_frames);
+
+    FILE *fp = fopen(name.data(), "wb");
+
+    if (fp == NULL)
+        return std::string("The file ") + name.data() + " could not be opened";
+
+    bool written = fwrite(m_encoded.data(), 1, m_encoded.size(), fp) == m_encoded.size();
+    written &= fclose(fp) == 0;
+
+    if (!written)
+        return std::string("The file ") + name.data() + " could not be written";
+
+    return "";
+}
+
+std::string VideoWriter::__write_y4m()
+{
+    const int width = m_splatter.m_width, height = m_splatter.m_height;
+    const size_t n_pixels = size_t(width) * height;
+
+    m_encoded.resize(n_pixels * 3 / 2);
+    unsigned char *luma = m_encoded.data();
+    unsigned char *cb = luma + n_pixels;
+    unsigned char *cr = cb + n_pixels / 4;
+
+    // BT.601 in the video range, with the chroma averaged over each block of 2 x 2 pixels
+    for (int y = 0; y < height; y += 2)
+        for (int x = 0; x < width; x += 2)
+        {
+            float u = 0, v = 0;
+
+            for (int k = 0; k < 4; k++)
+            {
+                const size_t p = size_t(y + k / 2) * width + x + k % 2;
+                const float r = m_image[3 * p], g = m_image[3 * p + 1], b = m_image[3 * p + 2];
+
+                luma[p] = std::lround(16 + 0.256788f * r + 0.504129f * g + 0.097906f * b);
+                u += -0.148223f * r - 0.290993f * g + 0.439216f * b;
+                v += 0.439216f * r - 0.367788f * g - 0.071427f * b;
+            }
+
+            const size_t c = size_t(y / 2) * (width / 2) + x / 2;
+            cb[c] = std::lround(128 + u / 4);
+            cr[c] = std::lround(128 + v / 4);
+        }
+
+    bool written = fputs("FRAME\n", m_stream) >= 0;
+    written &= fwrite(m_encoded.data(), 1, m_encoded.size(), m_stream) == m_encoded.size();
+
+    if (!written)
+        return "The video " + m_path + " could not be written";
+
+    return "";
+}
@@ -1,5 +1,163 @@
 #include "../include/view.hpp"
 #include <GL/freeglut.h> // Include the necessary header file
+#include <cstdio>
+#include <limits>
+
+// The shaders of the point sprite renderer, in GLSL 1.20 (OpenGL 2.1), which the software rendering of Mesa supports.
+// Each molecule is a point, as wide on the screen as its diameter, shaded as a sphere in the fragment shader
+static const char *VERTEX_SHADER =
+    "#version 120\n"
+    "attribute float a_x, a_y, a_z, a_diameter, a_species;\n"
+    "uniform float u_scale;\n"
+    "varying float v_species;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 eye = gl_ModelViewMatrix * vec4(a_x, a_y, a_z, 1.0);\n"
+    "    gl_Position = gl_ProjectionMatrix * eye;\n"
+    "    gl_PointSize = max(1.0, u_scale * a_diameter / -eye.z);\n"
+    "    v_species = a_species;\n"
+    "}\n";
+
+static const char *FRAGMENT_SHADER =
+    "#version 120\n"
+    "uniform sampler1D u_colors;\n"
+    "uniform float u_n_species;\n"
+    "uniform bool u_flat;\n"
+    "varying float v_species;\n"
+    "void main()\n"
+    "{\n"
+    "    vec3 color = texture1D(u_colors, (v_species + 0.5) / u_n_species).rgb;\n"
+    "    if (u_flat)\n"
+    "    {\n"
+    "        gl_FragColor = vec4(color, 1.0);\n"
+    "        return;\n"
+    "    }\n"
+    "    vec2 p = gl_PointCoord * 2.0 - 1.0;\n"
+    "    float r2 = dot(p, p);\n"
+    "    if (r2 > 1.0)\n"
+    "        discard;\n"
+    "    gl_FragColor = vec4(color * (0.4 + 0.6 * sqrt(1.0 - r2)), 1.0);\n"
+    "}\n";
+
+// The shaders of the density impostors: each one is a soft disc, as wide as its cell on the screen,
+// whose opacity is the part of the cell covered by its molecules
+static const char *IMPOSTOR_VERTEX_SHADER =
+    "#version 120\n"
+    "attribute vec3 a_position;\n"
+    "attribute float a_size;\n"
+    "attribute vec4 a_color;\n"
+    "varying vec4 v_color;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(a_position, 1.0);\n"
+    "    gl_PointSize = a_size;\n"
+    "    v_color = a_color;\n"
+    "}\n";
+
+static const char *IMPOSTOR_FRAGMENT_SHADER =
+    "#version 120\n"
+    "varying vec4 v_color;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 p = gl_PointCoord * 2.0 - 1.0;\n"
+    "    float r2 = dot(p, p);\n"
+    "    if (r2 > 1.0)\n"
+    "        discard;\n"
+    "    gl_FragColor = vec4(v_color.rgb, v_color.a * (1.0 - r2));\n"
+    "}\n";
+
+/**
+ * @brief Compile a shader
+ *
+ * @param type The type of the shader
+ * @param source The source of the shader
+ * @return GLuint The shader. (0 if it does not compile)
+ */
+static GLuint compile_shader(GLenum type, const char *source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+
+    if (compiled != GL_TRUE)
+    {
+        char log[1024] = {0};
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "The shader could not be compiled: %s\n", log);
+
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+/**
+ * @brief Compile and link a shader program
+ *
+ * @param vertex_source The source of the vertex shader
+ * @param fragment_source The source of the fragment shader
+ * @param names The names of the attributes, bound to the locations 0, 1, ...
+ * @param n_names The number of attributes
+ * @return GLuint The program. (0 if it does not build)
+ */
+static GLuint link_program(const char *vertex_source, const char *fragment_source, const char **names, int n_names)
+{
+    GLuint vertex = compile_shader(GL_VERTEX_SHADER, vertex_source);
+    GLuint fragment = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+    GLuint program = 0;
+
+    if (vertex && fragment)
+    {
+        program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+
+        for (int a = 0; a < n_names; a++)
+            glBindAttribLocation(program, a, names[a]);
+
+        glLinkProgram(program);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+        if (linked != GL_TRUE)
+        {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (vertex)
+        glDeleteShader(vertex);
+    if (fragment)
+        glDeleteShader(fragment);
+
+    return program;
+}
+
+/**
+ * @brief Add a range of molecules to draw, merged with the previous one when they are contiguous
+ *
+ * @param first The first molecule of each range
+ * @param count The number of molecules of each range
+ * @param start The first molecule of the range to add
+ * @param n The number of molecules of the range to add
+ */
+static void add_range(std::vector<GLint> &first, std::vector<GLsizei> &count, GLint start, GLsizei n)
+{
+    if (!first.empty() && first.back() + count.back() == start)
+        count.back() += n;
+
+    else
+    {
+        first.push_back(start);
+        count.push_back(n);
+    }
+}
 
 // ============================
 // CONSTRUCTORS
@@ -12,6 +170,12 @@ View::View(Simulation simulation, int vesicle_radius, int detail_x, int detail_y
                                                                                     m_detail_x(detail_x),
                                                                                     m_detail_y(detail_y) {}
 
+View::~View()
+{
+    // The simulation thread must stop before the simulation is destroyed
+    m_runner.reset();
+}
+
 // ============================
 // GENERAL FUNCTIONS
 void View::init_opengl(int argc, char **argv)
@@ -30,6 +194,7 @@ void View::init_opengl(int argc, char **argv)
     glutDisplayFunc(View::static_draw_scene);
     glutMouseFunc(View::static_on_mouse_click);
     glutSpecialFunc(View::static_on_key_pressed);
+    glutKeyboardFunc(View::static_on_char_pressed);
 
     // Set the clear color
     glClearColor(0.137, 0.137, 0.137, 1.0);
@@ -45,6 +210,12 @@ void View::init_opengl(int argc, char **argv)
     glMatrixMode(GL_MODELVIEW);
     glEnable(GL_DEPTH_TEST);
 
+    // The callbacks draw with the instance, which owns the renderer
+    View::instance().__init_renderer();
+
+    // From now on, the simulation is only stepped by its thread, and the view draws its snapshots
+    View::instance().m_runner = std::make_unique<Runner>(View::instance().m_simulation);
+
     glutTimerFunc(1000 / 60, [](int value) { View::instance().update_simulation(value); }, 0);
 }
 
@@ -56,7 +227,7 @@ void View::display()
 void View::__set_simulation(const Simulation &simulation)
 {
     m_simulation = simulation;
-    __map_colors();
+    __init_render_table();
 }
 
 // ============================
@@ -68,8 +239,15 @@ void View::draw_vesicle()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glColor4f(1.0, 1.0, 1.0, 0.1);
 
+    // The detail decreases with the size of the vesicle on the screen, and is full from inside
+    const float distance = std::sqrt(m_camera[0] * m_camera[0] + m_camera[1] * m_camera[1] + m_camera[2] * m_camera[2]);
+    float scale = 1;
+
+    if (m_use_lod && distance > m_vesicle_radius)
+        scale = std::min(1.f, m_focal * m_vesicle_radius / distance / m_VESICLE_FULL_PIXELS);
+
     // Draw the vesicle sphere
-    glutWireSphere(m_vesicle_radius, m_detail_x, m_detail_y);
+    glutWireSphere(m_vesicle_radius, std::max(8, int(std::lround(m_detail_x * scale))), std::max(4, int(std::lround(m_detail_y * scale))));
 }
 
 void View::draw_legend()
@@ -84,35 +262,39 @@ void View::draw_legend()
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
+    const Snapshot &snapshot = m_runner->m_snapshots.front();
+
     int y = m_height - 30; // Start 30 pixels from the top
 
     // Display the time
     glColor3f(1.0, 1.0, 1.0);
     glRasterPos2f(20, y);
-    std::string text = "Time: " + std::to_string(m_simulation.m_time);
+    std::string text = "Time: " + std::to_string(snapshot.m_time);
     glutBitmapString(GLUT_BITMAP_HELVETICA_18, reinterpret_cast<const unsigned char *>(text.c_str()));
 
-    y -= 30; // Move down 20 pixels for the next line
+    y -= 20;
 
-    // Draw the text and color circle for each molecule type
-    for (auto &&ident : m_simulation.m_ident_molecules)
-    {
-        // Calculate the number of molecules of this type
-        int count = std::count_if(m_simulation.m_molecules.begin(), m_simulation.m_molecules.end(),
-                                  [&ident](const Molecule &m)
-                                  { return m.ident == ident; });
+    // Display the speed of the simulation
+    glRasterPos2f(20, y);
+    if (m_runner->paused())
+        text = "Tick " + std::to_string(snapshot.m_tick) + ", paused";
+    else if (m_runner->uncapped())
+        text = "Tick " + std::to_string(snapshot.m_tick) + ", uncapped";
+    else
+        text = "Tick " + std::to_string(snapshot.m_tick) + ", " + std::to_string(m_runner->ticks_per_frame()) + " per frame";
+    glutBitmapString(GLUT_BITMAP_HELVETICA_12, reinterpret_cast<const unsigned char *>(text.c_str()));
 
-        // Get the molecule color
-        std::tuple<float, float, float> color = m_colors[ident];
-        glColor3f(std::get<0>(color), std::get<1>(color), std::get<2>(color));
+    y -= 20;
 
-        // Draw the molecule name and count
-        glRasterPos2f(20, y);
-        std::string text = m_simulation.m_names[ident] + ": " + std::to_string(count);
-        glutBitmapString(GLUT_BITMAP_HELVETICA_18, reinterpret_cast<const unsigned char *>(text.c_str()));
+    // Display how the molecules of the last frame have been drawn
+    glRasterPos2f(20, y);
+    text = std::to_string(m_drawn_spheres) + " spheres, " + std::to_string(m_drawn_points) + " points, " +
+           std::to_string(m_drawn_impostors) + " impostors";
+    glutBitmapString(GLUT_BITMAP_HELVETICA_12, reinterpret_cast<const unsigned char *>(text.c_str()));
 
-        y -= 20; // Move down 20 pixels for the next line
-    }
+    // The labels of the species, 30 pixels lower, are replayed from their display list
+    __update_legend(snapshot);
+    glCallList(m_legend_list);
 
     // Restore the original matrix
     glPopMatrix();
@@ -126,20 +308,311 @@ void View::draw_legend()
 
 void View::draw_molecules()
 {
-    for (Molecule m : m_simulation.m_molecules)
+    const Snapshot &snapshot = m_runner->m_snapshots.front();
+
+    __select_detail(snapshot);
+
+    if (m_use_sprites && m_program)
+        __draw_sprites(snapshot);
+
+    else
+        __draw_spheres(snapshot);
+
+    __draw_impostors();
+}
+
+void View::__init_frame()
+{
+    GLfloat modelview[16], projection[16], clip[16];
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+
+    // The matrix from the space of the vesicle to the clip space, in column-major order
+    for (int c = 0; c < 4; c++)
+        for (int r = 0; r < 4; r++)
+        {
+            clip[c * 4 + r] = 0;
+            for (int k = 0; k < 4; k++)
+                clip[c * 4 + r] += projection[k * 4 + r] * modelview[c * 4 + k];
+        }
+
+    // The planes are the sums and the differences of the last row with the others (Gribb and Hartmann)
+    for (int p = 0; p < 6; p++)
+    {
+        const int row = p / 2;
+        const float sign = p % 2 ? -1 : 1;
+
+        for (int c = 0; c < 4; c++)
+            m_planes[p][c] = clip[c * 4 + 3] + sign * clip[c * 4 + row];
+    }
+
+    // The model-view matrix is a rotation and a translation, so the camera is at -R^T * t
+    for (int a = 0; a < 3; a++)
+        m_camera[a] = -(modelview[a * 4] * modelview[12] + modelview[a * 4 + 1] * modelview[13] + modelview[a * 4 + 2] * modelview[14]);
+
+    m_focal = m_height / (2 * std::tan(45.0 / 2 * M_PI / 180));
+}
+
+void View::__select_detail(const Snapshot &snapshot)
+{
+    m_sphere_first.clear();
+    m_sphere_count.clear();
+    m_point_first.clear();
+    m_point_count.clear();
+    m_impostors.clear();
+
+    m_drawn_spheres = m_drawn_points = m_drawn_impostors = 0;
+
+    if (!m_use_lod)
+    {
+        add_range(m_sphere_first, m_sphere_count, 0, snapshot.size());
+        m_drawn_spheres = snapshot.size();
+        return;
+    }
+
+    // The molecules stick out of their cell by their radius at most
+    float margin = 0;
+    for (auto &&species : m_simulation.m_species)
+        margin = std::max(margin, species.diameter / 2);
+
+    // The state of the current cell: its distance to the camera, or -1 when it is culled,
+    // and the molecules aggregated into its impostor
+    int cell = -1;
+    float distance = 0;
+    double impostor[7] = {0, 0, 0, 0, 0, 0, 0}; // x, y, z, r, g, b sums, and the covered area in pixels
+    unsigned int aggregated = 0;
+
+    auto flush_impostor = [&]()
+    {
+        if (aggregated == 0)
+            return;
+
+        // The disc of the impostor covers the projection of its cell, and overlaps those of its neighbours.
+        // Its opacity is the part of the cell covered by its molecules
+        const float cell_pixels = m_focal * snapshot.m_cell_size / distance;
+        const float size = std::max(1.f, m_IMPOSTOR_SPREAD * cell_pixels);
+        const float alpha = std::min(1., impostor[6] / (cell_pixels * cell_pixels));
+
+        m_impostors.insert(m_impostors.end(), {float(impostor[0] / aggregated), float(impostor[1] / aggregated), float(impostor[2] / aggregated), size,
+                                               float(impostor[3] / aggregated), float(impostor[4] / aggregated), float(impostor[5] / aggregated), alpha});
+        m_drawn_impostors++;
+
+        std::fill(impostor, impostor + 7, 0);
+        aggregated = 0;
+    };
+
+    for (auto &&bucket : snapshot.m_buckets)
     {
-        glPushMatrix();
+        if (bucket.cell != cell)
+        {
+            flush_impostor();
+            cell = bucket.cell;
+
+            float low[3], high[3];
+            snapshot.cell_bounds(cell, low, high);
 
-        glTranslatef(m.position.x, m.position.y, m.position.z);
-        glColor3f(std::get<0>(m_colors[m.ident]), std::get<1>(m_colors[m.ident]), std::get<2>(m_colors[m.ident]));
+            // The cell is culled if it is entirely behind one of the planes of the frustum
+            distance = 0;
+            for (int p = 0; p < 6 && distance >= 0; p++)
+            {
+                float d = m_planes[p][3];
+                for (int a = 0; a < 3; a++)
+                    d += m_planes[p][a] * (m_planes[p][a] > 0 ? high[a] + margin : low[a] - margin);
 
-        glutSolidSphere(m.diameter / 2, 5, 5);
-        glPopMatrix();
+                if (d < 0)
+                    distance = -1;
+            }
+
+            // Otherwise, its distance is the one of its nearest point, at least the near plane
+            if (distance == 0)
+            {
+                float squared = 0;
+                for (int a = 0; a < 3; a++)
+                {
+                    const float nearest = std::max(low[a], std::min(high[a], m_camera[a]));
+                    squared += (nearest - m_camera[a]) * (nearest - m_camera[a]);
+                }
+
+                distance = std::max(1.f, std::sqrt(squared));
+            }
+        }
+
+        if (distance < 0)
+            continue;
+
+        const float pixels = m_focal * m_simulation.m_species[bucket.species].diameter / distance;
+        const float cell_pixels = m_focal * snapshot.m_cell_size / distance;
+        const float area = M_PI / 4 * pixels * pixels * bucket.count;
+
+        if (pixels >= m_SPHERE_PIXELS)
+        {
+            add_range(m_sphere_first, m_sphere_count, bucket.start, bucket.count);
+            m_drawn_spheres += bucket.count;
+        }
+
+        else if (pixels >= m_IMPOSTOR_PIXELS && area < m_IMPOSTOR_COVERAGE * cell_pixels * cell_pixels)
+        {
+            add_range(m_point_first, m_point_count, bucket.start, bucket.count);
+            m_drawn_points += bucket.count;
+        }
+
+        // The molecules under a pixel only add their color and their area to the impostor of their cell
+        else
+        {
+            const std::tuple<float, float, float> &color = m_species_render[bucket.species].color;
+
+            impostor[0] += double(bucket.x) * bucket.count;
+            impostor[1] += double(bucket.y) * bucket.count;
+            impostor[2] += double(bucket.z) * bucket.count;
+            impostor[3] += std::get<0>(color) * bucket.count;
+            impostor[4] += std::get<1>(color) * bucket.count;
+            impostor[5] += std::get<2>(color) * bucket.count;
+            impostor[6] += area;
+            aggregated += bucket.count;
+        }
     }
+
+    flush_impostor();
+}
+
+void View::__draw_sprites(const Snapshot &snapshot)
+{
+    const GLsizei n = snapshot.size();
+
+    glUseProgram(m_program);
+    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+    glEnable(GL_POINT_SPRITE);
+    glDisable(GL_BLEND);
+
+    // The size of an object of width 1 at a distance of 1, in pixels
+    glUniform1f(glGetUniformLocation(m_program, "u_scale"), m_focal);
+    glUniform1f(glGetUniformLocation(m_program, "u_n_species"), std::max<size_t>(1, m_simulation.m_species.size()));
+    glUniform1i(glGetUniformLocation(m_program, "u_colors"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_1D, m_color_texture);
+
+    // The attributes are uploaded as they are stored, one array each, once per snapshot
+    const void *attributes[5] = {snapshot.m_x.data(), snapshot.m_y.data(), snapshot.m_z.data(),
+                                 snapshot.m_diameter.data(), snapshot.m_species.data()};
+    const GLenum types[5] = {GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_INT};
+
+    for (GLuint a = 0; a < 5; a++)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers[a]);
+        if (!m_uploaded)
+            glBufferData(GL_ARRAY_BUFFER, n * 4, attributes[a], GL_STREAM_DRAW);
+        glVertexAttribPointer(a, 1, types[a], GL_FALSE, 0, nullptr);
+        glEnableVertexAttribArray(a);
+    }
+
+    m_uploaded = true;
+
+    // The near molecules are shaded discs, and the far ones flat points
+    glUniform1i(glGetUniformLocation(m_program, "u_flat"), 0);
+    glMultiDrawArrays(GL_POINTS, m_sphere_first.data(), m_sphere_count.data(), m_sphere_first.size());
+
+    glUniform1i(glGetUniformLocation(m_program, "u_flat"), 1);
+    glMultiDrawArrays(GL_POINTS, m_point_first.data(), m_point_count.data(), m_point_first.size());
+
+    for (GLuint a = 0; a < 5; a++)
+        glDisableVertexAttribArray(a);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glDisable(GL_POINT_SPRITE);
+    glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+    glUseProgram(0);
+}
+
+void View::__draw_spheres(const Snapshot &snapshot)
+{
+    for (size_t r = 0; r < m_sphere_first.size(); r++)
+        for (GLint i = m_sphere_first[r]; i < m_sphere_first[r] + m_sphere_count[r]; i++)
+        {
+            const std::tuple<float, float, float> &color = m_species_render[snapshot.m_species[i]].color;
+            glPushMatrix();
+
+            glTranslatef(snapshot.m_x[i], snapshot.m_y[i], snapshot.m_z[i]);
+            glColor3f(std::get<0>(color), std::get<1>(color), std::get<2>(color));
+
+            glutSolidSphere(snapshot.m_diameter[i] / 2, 5, 5);
+            glPopMatrix();
+        }
+
+    glPointSize(1);
+    glBegin(GL_POINTS);
+
+    for (size_t r = 0; r < m_point_first.size(); r++)
+        for (GLint i = m_point_first[r]; i < m_point_first[r] + m_point_count[r]; i++)
+        {
+            const std::tuple<float, float, float> &color = m_species_render[snapshot.m_species[i]].color;
+            glColor3f(std::get<0>(color), std::get<1>(color), std::get<2>(color));
+            glVertex3f(snapshot.m_x[i], snapshot.m_y[i], snapshot.m_z[i]);
+        }
+
+    glEnd();
+}
+
+void View::__draw_impostors()
+{
+    if (m_impostors.empty())
+        return;
+
+    // The impostors are transparent: they are hidden by the molecules in front of them, without hiding the others
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+
+    if (m_use_sprites && m_impostor_program)
+    {
+        glUseProgram(m_impostor_program);
+        glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+        glEnable(GL_POINT_SPRITE);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_impostor_buffer);
+        glBufferData(GL_ARRAY_BUFFER, m_impostors.size() * sizeof(float), m_impostors.data(), GL_STREAM_DRAW);
+
+        const GLsizei stride = 8 * sizeof(float);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, nullptr);
+        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(3 * sizeof(float)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(4 * sizeof(float)));
+
+        for (GLuint a = 0; a < 3; a++)
+            glEnableVertexAttribArray(a);
+
+        glDrawArrays(GL_POINTS, 0, m_impostors.size() / 8);
+
+        for (GLuint a = 0; a < 3; a++)
+            glDisableVertexAttribArray(a);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDisable(GL_POINT_SPRITE);
+        glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+        glUseProgram(0);
+    }
+
+    else
+        for (size_t i = 0; i < m_impostors.size(); i += 8)
+        {
+            const float *impostor = m_impostors.data() + i;
+
+            glPointSize(impostor[3]);
+            glBegin(GL_POINTS);
+            glColor4f(impostor[4], impostor[5], impostor[6], impostor[7]);
+            glVertex3f(impostor[0], impostor[1], impostor[2]);
+            glEnd();
+        }
+
+    glDepthMask(GL_TRUE);
 }
 
 void View::draw_scene()
 {
+    // Draw the latest tick published by the simulation thread. Its molecules are uploaded once
+    if (m_runner->m_snapshots.acquire())
+        m_uploaded = false;
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     glLoadIdentity();
@@ -149,6 +622,8 @@ void View::draw_scene()
     glRotatef(__m_rotate_y, 0.0, 1.0, 0.0);
     glRotatef(__m_rotate_x, 1.0, 0.0, 0.0);
 
+    __init_frame();
+
     draw_vesicle();
     draw_molecules();
 
@@ -167,29 +642,109 @@ void View::draw_scene()
     glutSwapBuffers();
 }
 
-void View::__map_colors()
+void View::__init_render_table()
 {
-    const int &n_colors = m_simulation.m_ident_molecules.size();
+    const size_t n_species = m_simulation.m_species.size();
 
-    // Compute the number of colors per direction in the RGB space
-    const int &num_per_direction = ceil(pow(n_colors, 1.0 / 3.0));
+    m_species_render.assign(n_species, SpeciesRender());
+    for (size_t s = 0; s < n_species; s++)
+        m_species_render[s].color = Splatter::palette(s, n_species);
 
-    // Compute the spacing between each color
-    const int &spacing = ceil(255.0 / (num_per_direction - 1));
+    m_legend_changed = true;
+}
 
-    // Generate the colors for each molecule type
-    for (int r = 0; r < num_per_direction; ++r)
-        for (int g = 0; g < num_per_direction; ++g)
-            for (int b = 0; b < num_per_direction; ++b)
-            {
-                const int &id_color = r * num_per_direction * num_per_direction + g * num_per_direction + b;
-                const int &ident = m_simulation.m_ident_molecules[id_color];
+void View::__update_legend(const Snapshot &snapshot)
+{
+    // Only the labels of the counts which have changed are built again
+    for (size_t s = 0; s < m_species_render.size(); s++)
+    {
+        SpeciesRender &row = m_species_render[s];
+
+        if (row.label.empty() || row.count != snapshot.m_counts[s])
+        {
+            row.count = snapshot.m_counts[s];
+            row.label = m_simulation.species_name(s) + ": " + std::to_string(row.count);
+            m_legend_changed = true;
+        }
+    }
 
-                m_colors[ident] = {r * spacing, g * spacing, b * spacing};
+    if (m_legend_list == 0)
+        m_legend_list = glGenLists(1);
 
-                if (id_color == n_colors - 1)
-                    break;
-            }
+    else if (!m_legend_changed)
+        return;
+
+    // The glyphs of the labels are recorded once, and replayed at each frame
+    glNewList(m_legend_list, GL_COMPILE);
+
+    int y = m_height - 100; // Under the time and the state of the view
+
+    for (auto &&row : m_species_render)
+    {
+        glColor3f(std::get<0>(row.color), std::get<1>(row.color), std::get<2>(row.color));
+        glRasterPos2f(20, y);
+        glutBitmapString(GLUT_BITMAP_HELVETICA_18, reinterpret_cast<const unsigned char *>(row.label.c_str()));
+
+        y -= 20; // Move down 20 pixels for the next line
+    }
+
+    glEndList();
+    m_legend_changed = false;
+}
+
+void View::__init_renderer()
+{
+    // The buffers and the shaders are in OpenGL 2.0
+    const char *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+
+    if (version == nullptr || atoi(version) < 2)
+    {
+        fprintf(stderr, "OpenGL 2.0 is not supported, the molecules are drawn as spheres\n");
+        return;
+    }
+
+    // The attribute 0 must be used, since it is the position in the compatibility profile
+    const char *names[5] = {"a_x", "a_y", "a_z", "a_diameter", "a_species"};
+    m_program = link_program(VERTEX_SHADER, FRAGMENT_SHADER, names, 5);
+
+    const char *impostor_names[3] = {"a_position", "a_size", "a_color"};
+    m_impostor_program = link_program(IMPOSTOR_VERTEX_SHADER, IMPOSTOR_FRAGMENT_SHADER, impostor_names, 3);
+
+    if (!m_program || !m_impostor_program)
+    {
+        fprintf(stderr, "The shaders could not be built, the molecules are drawn as spheres\n");
+
+        if (m_program)
+            glDeleteProgram(m_program);
+        if (m_impostor_program)
+            glDeleteProgram(m_impostor_program);
+
+        m_program = m_impostor_program = 0;
+        return;
+    }
+
+    glGenBuffers(5, m_buffers);
+    glGenBuffers(1, &m_impostor_buffer);
+    glGenTextures(1, &m_color_texture);
+    __upload_colors();
+}
+
+void View::__upload_colors()
+{
+    // One texel by species, read without filtering
+    std::vector<float> texels;
+    for (auto &&row : m_species_render)
+        texels.insert(texels.end(), {std::get<0>(row.color), std::get<1>(row.color), std::get<2>(row.color)});
+
+    if (texels.empty())
+        texels.assign(3, 1);
+
+    glBindTexture(GL_TEXTURE_1D, m_color_texture);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB, texels.size() / 3, 0, GL_RGB, GL_FLOAT, texels.data());
+    glBindTexture(GL_TEXTURE_1D, 0);
 }
 
 // ============================
@@ -200,8 +755,8 @@ void View::static_update_simulation(int value) {
 }
 
 void View::update_simulation(int value) {
-    // Mettre à jour la simulation ici
-    m_simulation.move_all_molecules();
+    // Laisser le thread de la simulation faire les ticks de l'image
+    m_runner->frame();
 
     // Redessiner la scène
     glutPostRedisplay();
@@ -250,7 +805,38 @@ void View::on_key_pressed(int key, int x, int y)
         break;
 
     case GLUT_KEY_RIGHT:
-        m_simulation.move_all_molecules();
+        m_runner->step_once();
+        break;
+
+    default:
+        break;
+    }
+
+    glutPostRedisplay();
+}
+
+void View::on_char_pressed(unsigned char key, int, int)
+{
+    switch (key)
+    {
+    case ' ':
+        m_runner->set_paused(!m_runner->paused());
+        break;
+
+    case '+':
+        m_runner->set_ticks_per_frame(m_runner->ticks_per_frame() * 2);
+        break;
+
+    case '-':
+        m_runner->set_ticks_per_frame(m_runner->ticks_per_frame() / 2);
+        break;
+
+    case 'u':
+        m_runner->set_uncapped(!m_runner->uncapped());
+        break;
+
+    case 'l':
+        m_use_lod = !m_use_lod;
         break;
 
     default:
@@ -283,6 +869,11 @@ void View::static_on_key_pressed(int key, int x, int y)
     View::instance().on_key_pressed(key, x, y);
 }
 
+void View::static_on_char_pressed(unsigned char key, int x, int y)
+{
+    View::instance().on_char_pressed(key, x, y);
+}
+
 View &View::instance()
 {
     static View view = View();